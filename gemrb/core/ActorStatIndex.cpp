@@ -0,0 +1,88 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ActorStatIndex.h"
+
+#include "ie_stats.h"
+
+#include "Scriptable/Actor.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+// what the ID_ object selectors look at, see GameScript/Objects.cpp
+const std::array<unsigned int, ActorStatIndex::STAT_COUNT> ActorStatIndex::indexedStats = {
+	IE_EA, IE_GENERAL, IE_RACE, IE_SPECIFIC, IE_SEX, IE_ALIGNMENT
+};
+
+bool ActorStatIndex::Indexes(unsigned int stat) noexcept
+{
+	return std::find(indexedStats.begin(), indexedStats.end(), stat) != indexedStats.end();
+}
+
+void ActorStatIndex::Rebuild(const std::vector<Actor*>& actors)
+{
+	for (Buckets& stat : buckets) {
+		stat.clear();
+	}
+
+	for (size_t pos = 0; pos < actors.size(); ++pos) {
+		Actor* actor = actors[pos];
+		for (size_t i = 0; i < STAT_COUNT; ++i) {
+			buckets[i][actor->GetStat(indexedStats[i])].push_back({ pos, actor });
+		}
+	}
+	dirty = false;
+}
+
+bool ActorStatIndex::Find(const std::vector<Actor*>& actors, unsigned int stat, const Filter& accept, std::vector<Actor*>& found)
+{
+	auto idx = std::find(indexedStats.begin(), indexedStats.end(), stat);
+	if (idx == indexedStats.end()) return false;
+
+	if (dirty) {
+		Rebuild(actors);
+	}
+
+	found.clear();
+	const Buckets& stats = buckets[idx - indexedStats.begin()];
+	scratch.clear();
+	size_t matches = 0;
+	for (const auto& bucket : stats) {
+		if (!accept(bucket.first)) continue;
+		scratch.insert(scratch.end(), bucket.second.begin(), bucket.second.end());
+		++matches;
+	}
+
+	// several values matched, so restore the area order
+	if (matches > 1) {
+		std::sort(scratch.begin(), scratch.end(), [](const Entry& a, const Entry& b) {
+			return a.pos < b.pos;
+		});
+	}
+	found.reserve(scratch.size());
+	for (const Entry& entry : scratch) {
+		found.push_back(entry.actor);
+	}
+	return true;
+}
+
+}
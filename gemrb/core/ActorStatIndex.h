@@ -0,0 +1,73 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Actors of one area bucketed by the stats script object selectors compare
+// ([ENEMY], [0.0.0.0.GUARD] and friends), so a selector only has to look at
+// the actors that can possibly match instead of the whole area.
+// The buckets are rebuilt lazily after the owner reports a change in the
+// actor list or in one of the indexed stats of its actors.
+
+#ifndef ACTORSTATINDEX_H
+#define ACTORSTATINDEX_H
+
+#include "exports.h"
+#include "ie_types.h"
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace GemRB {
+
+class Actor;
+
+class GEM_EXPORT ActorStatIndex {
+public:
+	using Filter = std::function<bool(ieDword)>;
+
+	static bool Indexes(unsigned int stat) noexcept;
+
+	void Invalidate() noexcept { dirty = true; }
+
+	// the actors whose stat passes accept, in the order of the area actors
+	// returns false if the stat is not indexed
+	bool Find(const std::vector<Actor*>& actors, unsigned int stat, const Filter& accept, std::vector<Actor*>& found);
+
+private:
+	struct Entry {
+		size_t pos; // in the area actors
+		Actor* actor;
+	};
+	using Buckets = std::unordered_map<ieDword, std::vector<Entry>>;
+
+	static constexpr size_t STAT_COUNT = 6;
+	static const std::array<unsigned int, STAT_COUNT> indexedStats;
+
+	std::array<Buckets, STAT_COUNT> buckets;
+	std::vector<Entry> scratch;
+	bool dirty = true;
+
+	void Rebuild(const std::vector<Actor*>& actors);
+};
+
+}
+
+#endif
@@ -85,4 +85,15 @@ AnimationFactory::index_t AnimationFactory::GetCycleSize(index_t idx) const
 	return cycles[idx].FramesCount;
 }
 
+size_t AnimationFactory::GetDataSize() const
+{
+	size_t size = sizeof(AnimationFactory) + cycles.size() * sizeof(CycleEntry) + FLTable.size() * sizeof(index_t);
+	for (const auto& frame : frames) {
+		if (frame) {
+			size += sizeof(Sprite2D) + size_t(frame->GetPitch()) * frame->Frame.h;
+		}
+	}
+	return size;
+}
+
 }
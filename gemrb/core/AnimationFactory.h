@@ -51,6 +51,7 @@ public:
 	index_t GetCycleCount() const { return cycles.size(); }
 	index_t GetFrameCount() const { return frames.size(); }
 	index_t GetCycleSize(index_t idx) const;
+	size_t GetDataSize() const override;
 
 private:
 	std::vector<Holder<Sprite2D>> frames;
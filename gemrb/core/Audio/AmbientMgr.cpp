@@ -25,12 +25,14 @@
 #include "Interface.h"
 #include "RNG.h"
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 
 namespace GemRB {
 
 AmbientMgr::AmbientMgr()
+	: bufferCache(size_t(std::max(core->config.AudioCacheMB, 0)) * 1024 * 1024)
 {
 	player = std::thread(&AmbientMgr::Play, this);
 }
@@ -301,7 +303,8 @@ tick_t AmbientMgr::AmbientSource::Tick(tick_t ticks, Point listener, ieDword tim
 
 BufferCacheEntry AmbientMgr::AmbientSource::GetBuffer(ResRef resource, const AudioPlaybackConfig& config)
 {
-	auto entry = bufferCache.get().Lookup(resource);
+	std::string key { resource.c_str() };
+	auto entry = bufferCache.get().Lookup(key);
 	if (entry) {
 		return *entry;
 	}
@@ -312,14 +315,16 @@ BufferCacheEntry AmbientMgr::AmbientSource::GetBuffer(ResRef resource, const Aud
 	}
 
 	auto length = acm->GetLengthMs();
+	// it is always decoded into 16 bits
+	size_t size = acm->GetNumSamples() * 2;
 	auto handle = core->GetAudioDrv()->LoadSound(std::move(acm), config);
 	if (!handle) {
 		return {};
 	}
 
-	bufferCache.get().SetAt(resource, std::move(handle), length);
+	bufferCache.get().SetAt(key, BufferCacheEntry(std::move(handle), length), size);
 
-	return *bufferCache.get().Lookup(resource);
+	return *bufferCache.get().Peek(key);
 }
 
 // enqueues a random sound and returns its length
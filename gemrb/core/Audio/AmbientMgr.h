@@ -99,7 +99,7 @@ private:
 		tick_t Enqueue(const AudioPlaybackConfig& config);
 	};
 
-	AudioBufferCache bufferCache { 60 };
+	AudioBufferCache bufferCache;
 	std::vector<AmbientSource> ambientSources;
 
 	int Play();
@@ -23,4 +23,39 @@ namespace GemRB {
 
 const TypeID AudioBackend::ID = { "Audio" };
 
+DecodedSound::DecodedSound(ResourceHolder<SoundMgr> resource)
+	: length(resource->GetLengthMs())
+{
+	format.bits = 16;
+	format.channels = resource->GetChannels();
+	format.sampleRate = static_cast<uint16_t>(resource->GetSampleRate());
+
+	// it is always reading the stuff into 16 bits
+	auto numSamples = resource->GetNumSamples();
+	samples.resize(numSamples * 2);
+	auto count = resource->read_samples(reinterpret_cast<short*>(samples.data()), numSamples);
+	samples.resize(count * 2);
+}
+
+std::vector<char> DecodedSound::Channel(uint8_t channel) const
+{
+	if (format.channels <= 1) {
+		return samples;
+	}
+
+	size_t frameSize = format.channels * 2;
+	size_t frames = samples.size() / frameSize;
+	std::vector<char> mono(frames * 2);
+	for (size_t i = 0; i < frames; ++i) {
+		mono[i * 2] = samples[i * frameSize + channel * 2];
+		mono[i * 2 + 1] = samples[i * frameSize + channel * 2 + 1];
+	}
+	return mono;
+}
+
+Holder<SoundBufferHandle> AudioBackend::LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig& config)
+{
+	return CreateBuffer(DecodedSound(std::move(resource)), config);
+}
+
 }
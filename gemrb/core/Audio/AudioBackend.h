@@ -26,6 +26,8 @@
 #include "Plugin.h"
 #include "SoundMgr.h"
 
+#include <vector>
+
 namespace GemRB {
 
 // for SDL, and per channel; don't increase too much since it will make the volume slider delay
@@ -47,6 +49,20 @@ struct GEM_EXPORT AudioBufferFormat {
 	}
 };
 
+// a whole sound decoded to 16 bit samples, the expensive part of loading it
+// decoding only touches the resource itself, so it may run on any thread
+struct GEM_EXPORT DecodedSound {
+	AudioBufferFormat format;
+	std::vector<char> samples; // interleaved
+	time_t length = 0;
+
+	DecodedSound() = default;
+	explicit DecodedSound(ResourceHolder<SoundMgr> resource);
+
+	// the samples of just one channel, eg. for positional stereo
+	std::vector<char> Channel(uint8_t channel) const;
+};
+
 class GEM_EXPORT SoundBufferHandle {
 public:
 	virtual ~SoundBufferHandle() = default;
@@ -94,7 +110,12 @@ public:
 	virtual Holder<SoundStreamSourceHandle> CreateStreamable(
 		const AudioPlaybackConfig& config,
 		size_t minQueueSize = STREAM_QUEUE_MIN_SIZE) = 0;
-	virtual Holder<SoundBufferHandle> LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig& config) = 0;
+	// makes the samples playable, only on the main thread
+	virtual Holder<SoundBufferHandle> CreateBuffer(DecodedSound sound, const AudioPlaybackConfig& config) = 0;
+	// decodes and creates the buffer in one go
+	virtual Holder<SoundBufferHandle> LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig& config);
+	// false if the backend has no use for decoded samples
+	virtual bool WantsSamples() const { return true; }
 
 	virtual const AudioPoint& GetListenerPosition() const = 0;
 	virtual void SetListenerPosition(const AudioPoint&) = 0;
@@ -0,0 +1,152 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2025 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "BufferCache.h"
+
+#include "PluginMgr.h"
+
+#include "Streams/MemoryStream.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace GemRB {
+
+ResourceHolder<SoundMgr> EncodedSound::Open(const std::string& name) const
+{
+	// the importers check the signatures, so the first one to accept it is the right one
+	for (const auto& desc : PluginMgr::Get()->GetResourceDesc(&SoundMgr::ID)) {
+		void* copy = malloc(data.size());
+		std::memcpy(copy, data.data(), data.size());
+		auto sound = desc.Create(new MemoryStream(name, copy, data.size()));
+		if (sound) {
+			return std::static_pointer_cast<SoundMgr>(sound);
+		}
+	}
+	return nullptr;
+}
+
+size_t AudioBufferCache::Cost(const Item& item) noexcept
+{
+	return (item.entry.handle ? item.size : 0) + (item.encoded ? item.encoded->Size() : 0);
+}
+
+const BufferCacheEntry* AudioBufferCache::Lookup(const std::string& key)
+{
+	auto lookup = index.find(key);
+	if (lookup == index.end() || !lookup->second->entry.handle) {
+		++stats.misses;
+		return nullptr;
+	}
+
+	auto it = lookup->second;
+	++stats.hits;
+	++it->hits;
+	items.splice(items.end(), items, it);
+	return &it->entry;
+}
+
+const BufferCacheEntry* AudioBufferCache::Peek(const std::string& key) const
+{
+	auto lookup = index.find(key);
+	if (lookup == index.end() || !lookup->second->entry.handle) {
+		return nullptr;
+	}
+	return &lookup->second->entry;
+}
+
+void AudioBufferCache::SetAt(const std::string& key, BufferCacheEntry entry, size_t size, std::shared_ptr<const EncodedSound> encoded)
+{
+	Item item { key, std::move(entry), size, keepEncoded ? std::move(encoded) : nullptr, 0 };
+
+	// replacing is mostly a sound coming back from its encoded copy
+	auto lookup = index.find(key);
+	if (lookup != index.end()) {
+		item.hits = lookup->second->hits;
+		if (!item.encoded) {
+			item.encoded = lookup->second->encoded;
+		}
+		Erase(lookup->second);
+	}
+
+	MakeRoom(Cost(item));
+	usage += Cost(item);
+	index[key] = items.insert(items.end(), std::move(item));
+}
+
+std::shared_ptr<const EncodedSound> AudioBufferCache::GetEncoded(const std::string& key)
+{
+	auto lookup = index.find(key);
+	if (lookup == index.end() || !lookup->second->encoded) {
+		return nullptr;
+	}
+
+	++stats.encodedHits;
+	return lookup->second->encoded;
+}
+
+void AudioBufferCache::Erase(ItemList::iterator it)
+{
+	usage -= Cost(*it);
+	index.erase(it->key);
+	items.erase(it);
+}
+
+// drops the least recently used decoded buffer that isn't playing
+bool AudioBufferCache::EvictDecoded()
+{
+	for (auto it = items.begin(); it != items.end(); ++it) {
+		// careful, backends may already let go of the buffer here
+		if (!it->entry.handle || !it->entry.handle->Disposable()) continue;
+
+		++stats.evictions;
+		if (it->encoded && it->hits >= HOT_HITS) {
+			usage -= it->size;
+			it->entry = BufferCacheEntry();
+		} else {
+			Erase(it);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool AudioBufferCache::EvictEncoded()
+{
+	for (auto it = items.begin(); it != items.end(); ++it) {
+		if (it->entry.handle) continue;
+
+		Erase(it);
+		return true;
+	}
+	return false;
+}
+
+void AudioBufferCache::MakeRoom(size_t size)
+{
+	if (budget == 0) return;
+
+	while (usage + size > budget) {
+		if (!EvictDecoded() && !EvictEncoded()) {
+			break;
+		}
+	}
+}
+
+}
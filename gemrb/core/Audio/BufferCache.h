@@ -21,7 +21,12 @@
 #define H_AUDIO_BUFFER_CACHE
 
 #include "AudioBackend.h"
-#include "LRUCache.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace GemRB {
 
@@ -33,18 +38,78 @@ struct BufferCacheEntry {
 	explicit BufferCacheEntry(Holder<SoundBufferHandle> handle, time_t length)
 		: handle(std::move(handle)), length(length)
 	{}
-
-	void evictionNotice() const { /* No need. */ }
 };
 
-struct BufferInUse {
-	bool operator()(BufferCacheEntry& entry) const
-	{
-		return entry.handle->Disposable();
-	}
+// a sound as the game data stores it, eg. ACM, a fraction of its decoded size
+class GEM_EXPORT EncodedSound {
+	std::vector<char> data;
+
+public:
+	explicit EncodedSound(std::vector<char> data) noexcept
+		: data(std::move(data)) {}
+
+	size_t Size() const noexcept { return data.size(); }
+	// a fresh decoder over the kept data, nullptr if no sound plugin takes it
+	ResourceHolder<SoundMgr> Open(const std::string& name) const;
 };
 
-using AudioBufferCache = LRUCache<BufferCacheEntry, BufferInUse>;
+// Decoded sounds, least recently played ones are dropped once their size
+// exceeds the budget (in bytes, 0 means no limit). Sounds still playing are
+// never dropped, so the budget can be exceeded temporarily.
+// When keeping encoded copies, sounds played a few times keep theirs after
+// the decoded buffer is gone, so the next play only has to decode again.
+class GEM_EXPORT AudioBufferCache {
+public:
+	// plays after which a sound is worth keeping encoded
+	static constexpr unsigned int HOT_HITS = 2;
+
+	struct Stats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t encodedHits = 0; // misses that could use an encoded copy
+	};
+
+	explicit AudioBufferCache(size_t budget, bool keepEncoded = false) noexcept
+		: budget(budget), keepEncoded(keepEncoded) {}
+	AudioBufferCache(const AudioBufferCache&) = delete;
+	AudioBufferCache& operator=(const AudioBufferCache&) = delete;
+
+	// for playing the sound: counts towards the stats and keeps it around longer
+	const BufferCacheEntry* Lookup(const std::string& key);
+	// just checks, eg. whether there is something to decode
+	const BufferCacheEntry* Peek(const std::string& key) const;
+	// size is that of the decoded samples, encoded is only kept if enabled
+	void SetAt(const std::string& key, BufferCacheEntry entry, size_t size, std::shared_ptr<const EncodedSound> encoded = nullptr);
+	std::shared_ptr<const EncodedSound> GetEncoded(const std::string& key);
+
+	bool KeepsEncoded() const noexcept { return keepEncoded; }
+	size_t GetUsage() const noexcept { return usage; }
+	const Stats& GetStats() const noexcept { return stats; }
+
+private:
+	struct Item {
+		std::string key;
+		BufferCacheEntry entry; // no handle if only the encoded copy is left
+		size_t size = 0;
+		std::shared_ptr<const EncodedSound> encoded;
+		unsigned int hits = 0;
+	};
+	using ItemList = std::list<Item>;
+
+	ItemList items; // least recently used first
+	std::unordered_map<std::string, ItemList::iterator> index;
+	size_t budget;
+	bool keepEncoded;
+	size_t usage = 0;
+	Stats stats;
+
+	static size_t Cost(const Item& item) noexcept;
+	void Erase(ItemList::iterator it);
+	bool EvictDecoded();
+	bool EvictEncoded();
+	void MakeRoom(size_t size);
+};
 
 }
 
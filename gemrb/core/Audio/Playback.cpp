@@ -21,8 +21,25 @@
 
 #include "Interface.h"
 
+#include "System/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+
 namespace GemRB {
 
+static ThreadPool& DecodeWorkers()
+{
+	// sounds are short, a couple of threads keep up with any battle
+	static ThreadPool workers(2);
+	return workers;
+}
+
+static std::string CacheKey(StringView resource)
+{
+	return std::string(resource.c_str(), resource.length());
+}
+
 PlaybackHandle::PlaybackHandle(Holder<SoundSourceHandle> source, time_t length, int32_t height)
 	: source(std::move(source)), length(length), height(height)
 {}
@@ -34,6 +51,9 @@ time_t PlaybackHandle::GetLengthMs() const
 
 bool PlaybackHandle::IsPlaying() const
 {
+	if (waiting) {
+		return true;
+	}
 	if (source) {
 		return !source->HasFinishedPlaying();
 	}
@@ -57,6 +77,7 @@ void PlaybackHandle::StopLooping()
 
 void PlaybackHandle::Stop()
 {
+	waiting = false;
 	if (source) {
 		source->Stop();
 		source.reset();
@@ -64,9 +85,18 @@ void PlaybackHandle::Stop()
 }
 
 AudioPlayback::AudioPlayback(const std::vector<ResRef>& defaultSounds)
-	: defaultSounds(defaultSounds)
+	: bufferCache(size_t(std::max(core->config.AudioCacheMB, 0)) * 1024 * 1024, core->config.KeepEncodedSounds),
+	  defaultSounds(defaultSounds)
 {}
 
+AudioPlayback::~AudioPlayback()
+{
+	// the decoders come from plugins, so they must not outlive us
+	for (auto& pending : decoding) {
+		pending.second.sound.wait();
+	}
+}
+
 Holder<PlaybackHandle> AudioPlayback::Play(StringView resource, AudioPreset preset, SFXChannel channel)
 {
 	auto& settings = core->GetAudioSettings();
@@ -104,20 +134,7 @@ Holder<PlaybackHandle> AudioPlayback::Play(StringView resource, const AudioPlayb
 		return {};
 	}
 
-	auto cacheEntry = GetBuffer(resource, config);
-	if (!cacheEntry.handle) {
-		return {};
-	}
-
-	auto source = core->GetAudioDrv()->CreatePlaybackSource(config);
-	if (!source) {
-		return {};
-	}
-	source->Enqueue(std::move(cacheEntry.handle));
-
-	activeSources.insert(source);
-
-	return MakeHolder<PlaybackHandle>(std::move(source), cacheEntry.length, config.position.z);
+	return Start(resource, config);
 }
 
 Holder<PlaybackHandle> AudioPlayback::PlayDefaultSound(size_t index, SFXChannel channel)
@@ -133,21 +150,7 @@ Holder<PlaybackHandle> AudioPlayback::PlayDefaultSound(size_t index, const Audio
 		return {};
 	}
 
-	auto resource = defaultSounds[index];
-	auto cacheEntry = GetBuffer(resource, config);
-	if (!cacheEntry.handle) {
-		return {};
-	}
-
-	auto source = core->GetAudioDrv()->CreatePlaybackSource(config);
-	if (!source) {
-		return {};
-	}
-	source->Enqueue(std::move(cacheEntry.handle));
-
-	activeSources.insert(source);
-
-	return MakeHolder<PlaybackHandle>(std::move(source), cacheEntry.length, config.position.z);
+	return Start(defaultSounds[index], config);
 }
 
 time_t AudioPlayback::PlaySpeech(StringView resource, const AudioPlaybackConfig& config, bool interrupt)
@@ -184,27 +187,135 @@ void AudioPlayback::StopSpeech()
 	}
 }
 
-BufferCacheEntry AudioPlayback::GetBuffer(StringView resource, const AudioPlaybackConfig& config)
+void AudioPlayback::Prefetch(StringView resource, const AudioPlaybackConfig& config)
 {
-	auto cacheEntry = bufferCache.Lookup(resource);
-	if (cacheEntry) {
-		return *cacheEntry;
+	if (resource.empty()) {
+		return;
 	}
 
-	ResourceHolder<SoundMgr> acm = gamedata->GetResourceHolder<SoundMgr>(resource);
-	if (!acm) {
+	std::string key = CacheKey(resource);
+	if (!bufferCache.Peek(key)) {
+		Decode(key, resource, config);
+	}
+}
+
+Holder<PlaybackHandle> AudioPlayback::Start(StringView resource, const AudioPlaybackConfig& config)
+{
+	std::string key = CacheKey(resource);
+	const BufferCacheEntry* cacheEntry = bufferCache.Lookup(key);
+	time_t length = 0;
+	if (!cacheEntry) {
+		if (!Decode(key, resource, config)) {
+			return {};
+		}
+		// short sounds are often done already
+		auto pending = decoding.find(key);
+		if (pending != decoding.end()) {
+			length = pending->second.length;
+		}
+		cacheEntry = Collect(key, false);
+	}
+
+	auto source = core->GetAudioDrv()->CreatePlaybackSource(config);
+	if (!source) {
 		return {};
 	}
 
+	if (!cacheEntry) {
+		auto handle = MakeHolder<PlaybackHandle>(std::move(source), length, config.position.z);
+		handle->waiting = true;
+		waiting.push_back({ std::move(key), handle, GetMilliseconds() + MAX_START_DELAY });
+		return handle;
+	}
+
+	source->Enqueue(cacheEntry->handle);
+	activeSources.insert(source);
+
+	return MakeHolder<PlaybackHandle>(std::move(source), cacheEntry->length, config.position.z);
+}
+
+// queues the decoding of a sound that isn't cached yet, false if there is no such sound
+bool AudioPlayback::Decode(const std::string& key, StringView resource, const AudioPlaybackConfig& config)
+{
+	if (decoding.count(key)) {
+		return true;
+	}
+
+	ResourceHolder<SoundMgr> acm;
+	auto encoded = bufferCache.GetEncoded(key);
+	if (encoded) {
+		acm = encoded->Open(key);
+	}
+	if (!acm) {
+		acm = gamedata->GetResourceHolder<SoundMgr>(resource);
+	}
+	if (!acm) {
+		return false;
+	}
+
 	auto length = acm->GetLengthMs();
-	auto handle = core->GetAudioDrv()->LoadSound(std::move(acm), config);
+	auto backend = core->GetAudioDrv();
+	if (!backend->WantsSamples()) {
+		// no point in bothering a thread, nor in keeping anything but the handle
+		auto handle = backend->LoadSound(std::move(acm), config);
+		if (!handle) {
+			return false;
+		}
+		bufferCache.SetAt(key, BufferCacheEntry(std::move(handle), length), 0);
+		return true;
+	}
+
+	if (!encoded && bufferCache.KeepsEncoded()) {
+		std::vector<char> data = acm->ReadEncoded();
+		if (!data.empty()) {
+			encoded = std::make_shared<const EncodedSound>(std::move(data));
+		}
+	}
+
+	// the decoder lets go of the resource before the result is ready, see ~AudioPlayback
+	auto sound = DecodeWorkers().Submit([acm]() mutable {
+		return DecodedSound(std::move(acm));
+	});
+	decoding.emplace(key, Decoding { std::move(sound), config, length, std::move(encoded) });
+	return true;
+}
+
+// moves a finished decoding into the cache
+const BufferCacheEntry* AudioPlayback::Collect(std::string key, bool wait)
+{
+	auto it = decoding.find(key);
+	if (it == decoding.end()) {
+		return bufferCache.Peek(key);
+	}
+
+	Decoding& pending = it->second;
+	if (!wait && pending.sound.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+		return nullptr;
+	}
+
+	DecodedSound sound = pending.sound.get();
+	size_t size = sound.samples.size();
+	auto handle = core->GetAudioDrv()->CreateBuffer(std::move(sound), pending.config);
+	auto length = pending.length;
+	auto encoded = std::move(pending.encoded);
+	decoding.erase(it);
 	if (!handle) {
-		return {};
+		return nullptr;
 	}
 
-	bufferCache.SetAt(resource, std::move(handle), length);
+	bufferCache.SetAt(key, BufferCacheEntry(std::move(handle), length), size, std::move(encoded));
+	return bufferCache.Peek(key);
+}
 
-	return *bufferCache.Lookup(resource);
+BufferCacheEntry AudioPlayback::GetBuffer(StringView resource, const AudioPlaybackConfig& config)
+{
+	std::string key = CacheKey(resource);
+	const BufferCacheEntry* cacheEntry = bufferCache.Lookup(key);
+	if (!cacheEntry && Decode(key, resource, config)) {
+		cacheEntry = Collect(key, true);
+	}
+
+	return cacheEntry ? *cacheEntry : BufferCacheEntry();
 }
 
 void AudioPlayback::Housekeeping()
@@ -216,6 +327,33 @@ void AudioPlayback::Housekeeping()
 			++it;
 		}
 	}
+
+	for (auto it = decoding.begin(); it != decoding.end();) {
+		auto next = std::next(it);
+		if (it->second.sound.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			Collect(it->first, false);
+		}
+		it = next;
+	}
+
+	// start what got decoded in the meantime, drop what was stopped or would be too late
+	tick_t now = GetMilliseconds();
+	for (auto it = waiting.begin(); it != waiting.end();) {
+		PlaybackHandle& handle = *it->handle;
+		const BufferCacheEntry* cacheEntry = handle.waiting ? bufferCache.Peek(it->resource) : nullptr;
+		if (cacheEntry) {
+			handle.source->Enqueue(cacheEntry->handle);
+			activeSources.insert(handle.source);
+		} else if (handle.waiting && now < it->deadline && decoding.count(it->resource)) {
+			++it;
+			continue;
+		} else if (handle.source) {
+			handle.source->Stop();
+		}
+
+		handle.waiting = false;
+		it = waiting.erase(it);
+	}
 }
 
 }
@@ -24,7 +24,10 @@
 #include "AudioSettings.h"
 #include "BufferCache.h"
 
+#include <future>
 #include <set>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // still in use by Python
@@ -44,14 +47,28 @@ public:
 	void StopLooping();
 
 private:
+	friend class AudioPlayback;
+
 	Holder<SoundSourceHandle> source;
 	time_t length = 0;
 	int32_t height = 0;
+	bool waiting = false; // for its sound to be decoded
 };
 
+// Sounds missing from the cache are decoded on worker threads, so playing
+// them doesn't stall the main thread. They start once decoded, unless that
+// takes longer than MAX_START_DELAY, since a late sound is worse than none.
+// Speech still waits for its decoding, its length is needed right away.
 class GEM_EXPORT AudioPlayback {
 public:
+	static constexpr tick_t MAX_START_DELAY = 250;
+	// well short of the cache size, so prefetching doesn't evict what is in use
+	static constexpr size_t MAX_PREFETCH = 16;
+
 	explicit AudioPlayback(const std::vector<ResRef>& defaultSounds);
+	AudioPlayback(const AudioPlayback&) = delete;
+	~AudioPlayback();
+	AudioPlayback& operator=(const AudioPlayback&) = delete;
 
 	Holder<PlaybackHandle> Play(StringView resource, AudioPreset preset, SFXChannel channel, const Point& point);
 	Holder<PlaybackHandle> Play(StringView resource, AudioPreset preset, SFXChannel channel);
@@ -60,15 +77,37 @@ public:
 	Holder<PlaybackHandle> PlayDefaultSound(size_t index, const AudioPlaybackConfig& config);
 	time_t PlaySpeech(StringView resource, const AudioPlaybackConfig& config, bool interrupt = true);
 	void StopSpeech();
+	// starts decoding in the background, so playing it later won't have to wait
+	void Prefetch(StringView resource, const AudioPlaybackConfig& config);
+	// also starts the sounds that got decoded, call it every frame
+	void Housekeeping();
+	const AudioBufferCache& GetBufferCache() const { return bufferCache; }
 
 private:
-	AudioBufferCache bufferCache { 40 };
+	struct Decoding {
+		std::future<DecodedSound> sound;
+		AudioPlaybackConfig config;
+		time_t length;
+		std::shared_ptr<const EncodedSound> encoded;
+	};
+
+	struct Waiting {
+		std::string resource;
+		Holder<PlaybackHandle> handle;
+		tick_t deadline;
+	};
+
+	AudioBufferCache bufferCache;
+	std::unordered_map<std::string, Decoding> decoding;
+	std::vector<Waiting> waiting;
 	Holder<SoundSourceHandle> speech;
 	std::set<Holder<SoundSourceHandle>> activeSources;
 
 	const std::vector<ResRef>& defaultSounds;
 
-	void Housekeeping();
+	Holder<PlaybackHandle> Start(StringView resource, const AudioPlaybackConfig& config);
+	bool Decode(const std::string& key, StringView resource, const AudioPlaybackConfig& config);
+	const BufferCacheEntry* Collect(std::string key, bool wait);
 	BufferCacheEntry GetBuffer(StringView resource, const AudioPlaybackConfig& config);
 };
 
@@ -0,0 +1,64 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "Cache.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+void CacheBudget::AddClient(Client* client)
+{
+	clients.push_back(client);
+}
+
+void CacheBudget::RemoveClient(Client* client)
+{
+	clients.erase(std::remove(clients.begin(), clients.end(), client), clients.end());
+}
+
+void CacheBudget::SetLimit(size_t bytes)
+{
+	limit = bytes;
+	Trim();
+}
+
+void CacheBudget::Trim()
+{
+	if (!limit) return;
+
+	while (usage > limit) {
+		Client* oldest = nullptr;
+		uint64_t oldestStamp = 0;
+		for (Client* client : clients) {
+			uint64_t stamp = client->OldestEvictable();
+			if (stamp && (!oldest || stamp < oldestStamp)) {
+				oldest = client;
+				oldestStamp = stamp;
+			}
+		}
+
+		// everything left is still in use
+		if (!oldest) break;
+		oldest->EvictOldest();
+	}
+}
+
+}
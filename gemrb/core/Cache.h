@@ -21,12 +21,16 @@
 #ifndef CACHE_H
 #define CACHE_H
 
+#include "exports.h"
 #include "globals.h"
 #include "ie_types.h"
 
+#include <list>
+#include <memory>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace GemRB {
 
@@ -34,13 +38,61 @@ namespace GemRB {
 using ReleaseFun = void (*)(void*);
 #endif
 
-/* Reference counting cache, a layer between STL containers and existing interfaces. */
+/* Byte budget shared by several caches of decoded resources.
+ * Once usage exceeds the limit, unreferenced entries are evicted across
+ * all the clients, least recently used first. A limit of 0 means no limit.
+ */
+class GEM_EXPORT CacheBudget {
+public:
+	class Client {
+	public:
+		virtual ~Client() noexcept = default;
+		// stamp of the least recently used evictable entry, 0 if there is none
+		virtual uint64_t OldestEvictable() const = 0;
+		// evicts that entry and returns the bytes it freed
+		virtual size_t EvictOldest() = 0;
+	};
+
+	explicit CacheBudget(size_t limit = 0) noexcept
+		: limit(limit) {}
+	CacheBudget(const CacheBudget&) = delete;
+	CacheBudget& operator=(const CacheBudget&) = delete;
+
+	void AddClient(Client* client);
+	void RemoveClient(Client* client);
+
+	void SetLimit(size_t bytes);
+	size_t GetLimit() const noexcept { return limit; }
+	size_t GetUsage() const noexcept { return usage; }
+
+	uint64_t NextStamp() noexcept { return ++clock; }
+	void Charge(size_t bytes) noexcept { usage += bytes; }
+	void Refund(size_t bytes) noexcept { usage -= std::min(bytes, usage); }
+	void Trim();
+
+private:
+	std::vector<Client*> clients;
+	size_t limit;
+	size_t usage = 0;
+	uint64_t clock = 0;
+};
+
+/* Reference counting cache, a layer between STL containers and existing interfaces.
+ * Without a budget, entries released with remove set are dropped right away.
+ * With one, they are kept around (and accounted for) until the budget needs the room.
+ */
 template<typename K, typename V, typename H>
-class RCCache {
+class RCCache : public CacheBudget::Client {
+public:
+	using Measure = size_t (*)(const V&);
+
 private:
 	struct Value {
 		V value;
 		int64_t refCount = 1;
+		size_t size = 0; // charged to the budget on first release
+		bool evictable = false;
+		typename std::list<std::pair<uint64_t, K>>::iterator lruPos;
 
 		explicit Value(V&& value)
 			: value(std::move(value)) {}
@@ -52,12 +104,52 @@ private:
 	};
 
 	std::unordered_map<K, Value, H> map;
+	// unreferenced entries released with remove set, least recently released first
+	std::list<std::pair<uint64_t, K>> lru;
+	CacheBudget* budget = nullptr;
+	Measure measure = nullptr;
+
+	void Pin(Value& valueItem)
+	{
+		if (valueItem.evictable) {
+			lru.erase(valueItem.lruPos);
+			valueItem.evictable = false;
+		}
+	}
+
+	void Unpin(const K& key, Value& valueItem)
+	{
+		Pin(valueItem);
+		valueItem.lruPos = lru.emplace(lru.end(), budget->NextStamp(), key);
+		valueItem.evictable = true;
+	}
 
 public:
+	RCCache() noexcept = default;
+	RCCache(const RCCache&) = delete;
+	RCCache& operator=(const RCCache&) = delete;
+
+	~RCCache() override
+	{
+		if (!budget) return;
+		for (const auto& entry : map) {
+			budget->Refund(entry.second.size);
+		}
+		budget->RemoveClient(this);
+	}
+
+	void SetBudget(CacheBudget* newBudget, Measure sizeOf)
+	{
+		budget = newBudget;
+		measure = sizeOf;
+		budget->AddClient(this);
+	}
+
 	V* GetResource(const K& key)
 	{
 		auto lookup = map.find(key);
 		if (lookup != map.cend()) {
+			Pin(lookup->second);
 			lookup->second.refCount++;
 
 			return &lookup->second.value;
@@ -66,6 +158,20 @@ public:
 		return nullptr;
 	}
 
+	// like GetResource, but without taking a reference (for callers that only copy the value)
+	const V* Peek(const K& key)
+	{
+		auto lookup = map.find(key);
+		if (lookup == map.end()) {
+			return nullptr;
+		}
+
+		if (lookup->second.evictable) {
+			Unpin(lookup->first, lookup->second);
+		}
+		return &lookup->second.value;
+	}
+
 	template<typename... ARGS>
 	std::pair<V*, bool> SetAt(const K& key, ARGS&&... args)
 	{
@@ -85,17 +191,37 @@ public:
 		if (lookup != map.end()) {
 			auto& valueItem = lookup->second;
 
+			bool released = valueItem.refCount == 1;
 			if (valueItem.refCount > 0) {
 				valueItem.refCount--;
 			}
 
-			if (remove && valueItem.refCount == 0) {
-				map.erase(lookup);
+			if (valueItem.refCount > 0) {
+				return valueItem.refCount;
+			}
 
+			if (!budget) {
+				if (remove) {
+					map.erase(lookup);
+				}
 				return 0;
+			} else if (!released) {
+				return 0;
+			}
+
+			if (!valueItem.size) {
+				valueItem.size = measure(valueItem.value);
+				budget->Charge(valueItem.size);
+			}
+			if (remove) {
+				Unpin(lookup->first, valueItem);
 			} else {
-				return valueItem.refCount;
+				// callers may still hold on to these, so they stay resident
+				Pin(valueItem);
 			}
+			budget->Trim();
+
+			return 0;
 		}
 
 		return -1;
@@ -106,16 +232,202 @@ public:
 		auto lookup = map.find(key);
 
 		if (lookup != map.cend()) {
-			return lookup->second.RefCount;
+			return lookup->second.refCount;
 		}
 
 		return -1;
 	}
+
+	uint64_t OldestEvictable() const override
+	{
+		return lru.empty() ? 0 : lru.front().first;
+	}
+
+	size_t EvictOldest() override
+	{
+		if (lru.empty()) return 0;
+
+		auto lookup = map.find(lru.front().second);
+		lru.pop_front();
+		size_t size = lookup->second.size;
+		map.erase(lookup);
+		budget->Refund(size);
+		return size;
+	}
 };
 
 template<typename V>
 using ResRefRCCache = RCCache<ResRef, V, CstrHashCI>;
 
+/* Cache of shared objects, which are kept after their last outside user lets go.
+ * Entries added as evictable are dropped, least recently used first, only
+ * when the budget needs the room and nobody else holds them anymore.
+ * Their users get handles that report back when the last one goes away,
+ * so unused entries wait in their own list and eviction doesn't search.
+ */
+template<typename K, typename V, typename H>
+class SharedCache : public CacheBudget::Client {
+public:
+	using object_t = std::shared_ptr<V>;
+
+private:
+	struct Entry {
+		K key;
+		object_t object;
+		size_t size;
+		bool evictable;
+		bool idle = false;
+		uint64_t used = 0;
+		std::weak_ptr<V> handle;
+	};
+	using list_t = std::list<Entry>;
+
+	// deleter of the handles, keeps the object alive even if the entry is gone
+	struct Release {
+		std::weak_ptr<SharedCache*> cache;
+		K key;
+		object_t object;
+
+		void operator()(V*)
+		{
+			object_t last = std::move(object);
+			auto owner = cache.lock();
+			if (owner) (*owner)->Released(key, last.get());
+		}
+	};
+
+	list_t idle; // unused evictable entries, least recently released first
+	list_t busy; // handed out or not evictable
+	std::unordered_map<K, typename list_t::iterator, H> map;
+	CacheBudget* budget = nullptr;
+	std::shared_ptr<SharedCache*> self = std::make_shared<SharedCache*>(this);
+
+	object_t Acquire(typename list_t::iterator it)
+	{
+		if (!it->object || !it->evictable) return it->object;
+
+		object_t handle = it->handle.lock();
+		if (handle) return handle;
+
+		if (it->idle) {
+			busy.splice(busy.end(), idle, it);
+			it->idle = false;
+		}
+		handle = object_t(it->object.get(), Release { self, it->key, it->object });
+		it->handle = handle;
+		return handle;
+	}
+
+	void Released(const K& key, const V* object)
+	{
+		auto lookup = map.find(key);
+		// replaced or dropped in the meantime
+		if (lookup == map.end() || lookup->second->object.get() != object) return;
+
+		auto it = lookup->second;
+		idle.splice(idle.end(), busy, it);
+		it->idle = true;
+		if (!budget) return;
+
+		it->used = budget->NextStamp();
+		budget->Trim();
+	}
+
+	void Erase(typename list_t::iterator it)
+	{
+		map.erase(it->key);
+		(it->idle ? idle : busy).erase(it);
+	}
+
+public:
+	SharedCache() noexcept = default;
+	SharedCache(const SharedCache&) = delete;
+	SharedCache& operator=(const SharedCache&) = delete;
+
+	~SharedCache() override
+	{
+		self.reset();
+		Clear();
+		if (budget) budget->RemoveClient(this);
+	}
+
+	void SetBudget(CacheBudget* newBudget)
+	{
+		budget = newBudget;
+		budget->AddClient(this);
+	}
+
+	// returns false if the key is not cached; a cached object may itself be null
+	bool Find(const K& key, object_t& object)
+	{
+		auto lookup = map.find(key);
+		if (lookup == map.end()) {
+			return false;
+		}
+
+		auto it = lookup->second;
+		if (it->idle && !it->object) {
+			idle.splice(idle.end(), idle, it);
+			if (budget) it->used = budget->NextStamp();
+		}
+		object = Acquire(it);
+		return true;
+	}
+
+	// returns the handle to use instead of the passed object, which the cache can't watch
+	object_t Set(const K& key, object_t object, size_t size, bool evictable = true)
+	{
+		auto lookup = map.find(key);
+		if (lookup != map.end()) {
+			if (budget) budget->Refund(lookup->second->size);
+			Erase(lookup->second);
+		}
+
+		list_t& list = evictable ? idle : busy;
+		auto it = list.insert(list.end(), Entry { key, std::move(object), size, evictable, evictable, 0, {} });
+		map.emplace(key, it);
+		object_t handle = Acquire(it);
+		if (!budget) return handle;
+
+		it->used = budget->NextStamp();
+		budget->Charge(size);
+		budget->Trim();
+		return handle;
+	}
+
+	void Clear()
+	{
+		if (budget) {
+			for (const auto& entry : idle) {
+				budget->Refund(entry.size);
+			}
+			for (const auto& entry : busy) {
+				budget->Refund(entry.size);
+			}
+		}
+		map.clear();
+		idle.clear();
+		busy.clear();
+	}
+
+	uint64_t OldestEvictable() const override
+	{
+		return idle.empty() ? 0 : idle.front().used;
+	}
+
+	size_t EvictOldest() override
+	{
+		if (idle.empty()) return 0;
+
+		// dropping the object may release handles to other entries, so only once this one is gone
+		object_t object = std::move(idle.front().object);
+		size_t size = idle.front().size;
+		budget->Refund(size);
+		Erase(idle.begin());
+		return size;
+	}
+};
+
 }
 
 #endif //CACHE_H
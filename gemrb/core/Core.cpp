@@ -46,6 +46,8 @@ BOOL WINAPI DllEntryPoint(HINSTANCE /*hinstDLL*/, DWORD /*fdwReason*/,
 
 namespace GemRB {
 
+tick_t VirtualMilliseconds = 0;
+
 //// Globally used functions
 
 /** Calculates distance between 2 points */
@@ -35,11 +35,12 @@ enum class DebugMode : uint32_t {
 	WINDOWS = 64,
 	FONTS = 128,
 	TEXT = 256,
-	PATHFINDER = 512
+	PATHFINDER = 512,
+	EFFECTS = 1024
 };
 
-bool InDebugMode(DebugMode modes) noexcept;
-bool SetDebugMode(DebugMode modes, BitOp op = BitOp::SET) noexcept;
+GEM_EXPORT bool InDebugMode(DebugMode modes) noexcept;
+GEM_EXPORT bool SetDebugMode(DebugMode modes, BitOp op = BitOp::SET) noexcept;
 
 }
 
@@ -42,6 +42,8 @@
 #include "Logging/Logging.h"
 #include "Scriptable/Actor.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
 static std::vector<EffectDesc> effectnames;
@@ -443,12 +445,77 @@ Effect* EffectQueue::CreateUnsummonEffect(const Effect* fx)
 	return newfx;
 }
 
+EffectQueue::EffectQueue(const EffectQueue& other)
+	: effects(other.effects), Owner(other.Owner)
+{
+	RebuildIndex();
+}
+
+EffectQueue& EffectQueue::operator=(const EffectQueue& other)
+{
+	if (this != &other) {
+		effects = other.effects;
+		Owner = other.Owner;
+		RebuildIndex();
+	}
+	return *this;
+}
+
+EffectQueue::OpcodeView<Effect> EffectQueue::EffectsWithOpcode(ieDword opcode)
+{
+	static const bucket_t none;
+	auto it = opcodeIndex.find(opcode);
+	return OpcodeView<Effect>(it == opcodeIndex.end() ? none : it->second);
+}
+
+EffectQueue::OpcodeView<const Effect> EffectQueue::EffectsWithOpcode(ieDword opcode) const
+{
+	static const bucket_t none;
+	auto it = opcodeIndex.find(opcode);
+	return OpcodeView<const Effect>(it == opcodeIndex.end() ? none : it->second);
+}
+
+void EffectQueue::Unindex(const Effect* fx)
+{
+	auto it = opcodeIndex.find(fx->Opcode);
+	if (it != opcodeIndex.end()) {
+		bucket_t& bucket = it->second;
+		auto slot = std::find(bucket.begin(), bucket.end(), fx);
+		if (slot != bucket.end()) {
+			bucket.erase(slot);
+			if (bucket.empty()) opcodeIndex.erase(it);
+			return;
+		}
+	}
+
+	// the opcode was changed behind our back, so it is still filed under the old one
+	for (auto bucket = opcodeIndex.begin(); bucket != opcodeIndex.end(); ++bucket) {
+		auto slot = std::find(bucket->second.begin(), bucket->second.end(), fx);
+		if (slot == bucket->second.end()) continue;
+
+		bucket->second.erase(slot);
+		if (bucket->second.empty()) opcodeIndex.erase(bucket);
+		return;
+	}
+}
+
+void EffectQueue::RebuildIndex()
+{
+	opcodeIndex.clear();
+	for (auto& fx : effects) {
+		opcodeIndex[fx.Opcode].push_back(&fx);
+	}
+}
+
 void EffectQueue::AddEffect(Effect* fx, bool insert)
 {
 	if (insert) {
 		effects.push_front(std::move(*fx));
+		bucket_t& bucket = opcodeIndex[effects.front().Opcode];
+		bucket.insert(bucket.begin(), &effects.front());
 	} else {
 		effects.push_back(std::move(*fx));
+		opcodeIndex[effects.back().Opcode].push_back(&effects.back());
 	}
 	delete fx;
 }
@@ -459,6 +526,7 @@ bool EffectQueue::RemoveEffect(const Effect* fx)
 {
 	for (auto f = effects.begin(); f != effects.end(); ++f) {
 		if (*fx == *f) {
+			Unindex(&*f);
 			effects.erase(f);
 			return true;
 		}
@@ -473,20 +541,68 @@ void EffectQueue::ApplyAllEffects(Actor* target)
 {
 	const auto& Opcodes = Globals::Get().Opcodes;
 
+	bool morphed = false;
 	for (auto& fx : effects) {
+		ieDword opcode = fx.Opcode;
 		if (Opcodes[fx.Opcode].Flags & EFFECT_REINIT_ON_LOAD) {
 			// pretend to be the first application (FirstApply==1)
 			ApplyEffect(target, &fx, 1);
 		} else {
 			ApplyEffect(target, &fx, 0);
 		}
+		// a few effects turn themselves into another opcode
+		morphed = morphed || fx.Opcode != opcode;
+	}
+
+	if (morphed) {
+		RebuildIndex();
 	}
 }
 
+bool EffectQueue::GetReplayKeys(std::vector<EffectReplayKey>& keys, ieDword gameTime) const
+{
+	const auto& Opcodes = Globals::Get().Opcodes;
+
+	keys.clear();
+	for (const auto& fx : effects) {
+		if (fx.TimingMode == FX_DURATION_JUST_EXPIRED) continue;
+		if (fx.Opcode >= Globals::MAX_EFFECTS || fx.FirstApply) return false;
+		// these change base stats, so they don't give the same result twice
+		if (fx.TimingMode == FX_DURATION_INSTANT_PERMANENT) return false;
+
+		const EffectDesc& ed = Opcodes[fx.Opcode];
+		if (!ed || !(ed.Flags & EFFECT_STAT_ONLY) || (ed.Flags & EFFECT_REINIT_ON_LOAD)) return false;
+
+		// only the timing changes what a stat effect does from one tick to the next
+		switch (DelayType(fx.TimingMode & 0xff)) {
+			case TimingType::Delayed:
+			case TimingType::Duration:
+				if (fx.Duration <= gameTime) return false;
+				break;
+			case TimingType::Permanent:
+				break;
+			default:
+				return false;
+		}
+
+		EffectReplayKey key;
+		key.fx = &fx;
+		key.Opcode = fx.Opcode;
+		key.Parameter1 = fx.Parameter1;
+		key.Parameter2 = fx.Parameter2;
+		key.Duration = fx.Duration;
+		key.TimingMode = fx.TimingMode;
+		key.IsVariable = fx.IsVariable;
+		keys.push_back(key);
+	}
+	return true;
+}
+
 void EffectQueue::Cleanup()
 {
 	for (auto f = effects.begin(); f != effects.end();) {
 		if (f->TimingMode == FX_DURATION_JUST_EXPIRED) {
+			Unindex(&*f);
 			f = effects.erase(f);
 		} else {
 			++f;
@@ -1378,7 +1494,7 @@ static inline bool IsLive(ieByte timingmode)
 //will be killed along with it
 void EffectQueue::RemoveAllEffects(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1555,7 +1671,7 @@ void EffectQueue::RemoveAllEffects(EffectRef& effectReference)
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithResource(ieDword opcode, const ResRef& resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) {
@@ -1576,7 +1692,7 @@ void EffectQueue::RemoveAllEffectsWithResource(EffectRef& effectReference, const
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithSource(ieDword opcode, const ResRef& source, int mode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		if (fx.SourceRef != source) continue;
 
@@ -1607,7 +1723,7 @@ void EffectQueue::RemoveAllEffectsWithSource(EffectRef& effectReference, const R
 //(works only if a higher stat means good for the target)
 void EffectQueue::RemoveAllDetrimentalEffects(ieDword opcode, ieDword current)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1644,7 +1760,7 @@ void EffectQueue::RemoveAllDetrimentalEffects(EffectRef& effectReference, ieDwor
 //opcode need to be removed (see removal of portrait icon)
 void EffectQueue::RemoveAllEffectsWithParam(ieDword opcode, ieDword param, bool param1)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (param1) {
@@ -1673,7 +1789,7 @@ void EffectQueue::RemoveAllEffectsWithParam1(EffectRef& effectReference, ieDword
 //Removes all effects with a matching resource field
 void EffectQueue::RemoveAllEffectsWithParamAndResource(ieDword opcode, ieDword param2, const ResRef& resource)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1803,7 +1919,7 @@ bool EffectQueue::RollDispelChance(ieDword casterLevel, ieDword level)
 
 const Effect* EffectQueue::HasOpcode(ieDword opcode) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1823,7 +1939,7 @@ const Effect* EffectQueue::HasEffect(EffectRef& effectReference) const
 
 Effect* EffectQueue::HasOpcode(ieDword opcode)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -1843,7 +1959,7 @@ Effect* EffectQueue::HasEffect(EffectRef& effectReference)
 
 const Effect* EffectQueue::HasOpcodeWithParam(ieDword opcode, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1868,7 +1984,7 @@ const Effect* EffectQueue::HasEffectWithParam(EffectRef& effectReference, ieDwor
 
 const Effect* EffectQueue::HasOpcodeWithParamPair(ieDword opcode, ieDword param1, ieDword param2) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1896,7 +2012,7 @@ const Effect* EffectQueue::HasEffectWithParamPair(EffectRef& effectReference, ie
 bool EffectQueue::DecreaseParam1OfEffect(ieDword opcode, ieDword amount)
 {
 	bool found = false;
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		ieDword& amount_left = fx.Parameter1;
@@ -1924,7 +2040,7 @@ bool EffectQueue::DecreaseParam1OfEffect(EffectRef& effectReference, ieDword amo
 //returns the damage amount NOT soaked
 int EffectQueue::DecreaseParam3OfEffect(ieDword opcode, ieDword amount, ieDword param2)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -1963,7 +2079,7 @@ static const int ids_stats[9] = { IE_FACTION, IE_TEAM, IE_EA, IE_GENERAL, IE_RAC
 int EffectQueue::BonusAgainstCreature(ieDword opcode, const Actor* actor) const
 {
 	ieDword sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Parameter1) {
@@ -2015,7 +2131,7 @@ int EffectQueue::BonusAgainstCreature(EffectRef& effectReference, const Actor* a
 int EffectQueue::BonusForParam2(ieDword opcode, ieDword param2) const
 {
 	int sum = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		MATCH_PARAM2()
@@ -2037,7 +2153,7 @@ int EffectQueue::MaxParam1(ieDword opcode, bool positive) const
 {
 	int max = 0;
 	ieDwordSigned param1 = 0;
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2060,7 +2176,7 @@ int EffectQueue::MaxParam1(EffectRef& effectReference, bool positive) const
 
 bool EffectQueue::WeaponImmunity(ieDword opcode, int enchantment, ieDword weapontype) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2100,7 +2216,7 @@ void EffectQueue::AddWeaponEffects(EffectQueue* fxqueue, EffectRef& fx_ref, ieDw
 	ieDword opcode = fx_ref.opcode;
 	Point p(-1, -1);
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (!param2 && fx.Parameter2 != param2) continue;
@@ -2120,7 +2236,7 @@ int EffectQueue::SumDamageReduction(EffectRef& effectReference, ieDword weaponEn
 	int remaining = 0;
 	int count = 0;
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 
@@ -2141,7 +2257,7 @@ int EffectQueue::SumDamageReduction(EffectRef& effectReference, ieDword weaponEn
 //useful for immunity vs spell, can't use item, etc.
 const Effect* EffectQueue::HasOpcodeWithResource(ieDword opcode, const ResRef& resource) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (fx.Resource != resource) continue;
@@ -2166,7 +2282,7 @@ const Effect* EffectQueue::HasEffectWithPower(EffectRef& effectReference, ieDwor
 
 const Effect* EffectQueue::HasOpcodeWithPower(ieDword opcode, ieDword power) const
 {
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		// NOTE: matching greater or equals!
@@ -2194,7 +2310,7 @@ const Effect* EffectQueue::HasSource(const ResRef& removed) const
 //used in contingency/sequencer code (cannot have the same contingency twice)
 const Effect* EffectQueue::HasOpcodeWithSource(ieDword opcode, const ResRef& removed) const
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (removed != fx.SourceRef) {
@@ -2300,7 +2416,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effectReference, const Effec
 	ieDword cnt = 1;
 	ieDword opcode = ResolveEffect(effectReference);
 
-	for (const auto& fx : effects) {
+	for (const auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		MATCH_LIVE_FX()
 		if (&fx == fx2) break;
@@ -2311,7 +2427,7 @@ unsigned int EffectQueue::GetEffectOrder(EffectRef& effectReference, const Effec
 
 void EffectQueue::ModifyEffectPoint(ieDword opcode, ieDword x, ieDword y)
 {
-	for (auto& fx : effects) {
+	for (auto& fx : EffectsWithOpcode(opcode)) {
 		MATCH_OPCODE()
 		fx.Pos = Point(x, y);
 		fx.Parameter3 = 0;
@@ -34,6 +34,8 @@
 
 #include <cstdlib>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace GemRB {
 
@@ -163,7 +165,25 @@ enum EffectFlags {
 	EFFECT_NO_ACTOR = 4,
 	EFFECT_REINIT_ON_LOAD = 8,
 	EFFECT_PRESET_TARGET = 16,
-	EFFECT_SPECIAL_UNDO = 32
+	EFFECT_SPECIAL_UNDO = 32,
+	EFFECT_STAT_ONLY = 64 // touches only AC, tohit and stats without post change functions, see Actor::ReplayEffects
+};
+
+/** The parts of an effect that the outcome of an EFFECT_STAT_ONLY opcode depends on */
+struct GEM_EXPORT EffectReplayKey {
+	const Effect* fx = nullptr;
+	ieDword Opcode = 0;
+	ieDword Parameter1 = 0;
+	ieDword Parameter2 = 0;
+	ieDword Duration = 0;
+	ieWord TimingMode = 0;
+	ieWord IsVariable = 0;
+
+	bool operator==(const EffectReplayKey& other) const noexcept
+	{
+		return fx == other.fx && Opcode == other.Opcode && Parameter1 == other.Parameter1 && Parameter2 == other.Parameter2 &&
+			Duration == other.Duration && TimingMode == other.TimingMode && IsVariable == other.IsVariable;
+	}
 };
 
 // unusual SpellProt types which need hacking (fake stats)
@@ -211,11 +231,49 @@ private:
 	/** List of Effects applied on the Actor */
 	using queue_t = std::list<Effect>;
 	queue_t effects;
+	/** The effects of each opcode in queue order, so lookups don't have to walk the whole queue.
+	 * Effects are filed under the opcode they had when added or after being applied. */
+	using bucket_t = std::vector<Effect*>;
+	std::unordered_map<ieDword, bucket_t> opcodeIndex;
 	/** Actor which is target of the Effects */
 	Scriptable* Owner = nullptr;
 
+	/** range over a bucket that yields effects instead of pointers */
+	template<typename T>
+	class OpcodeView {
+		const bucket_t* bucket;
+
+	public:
+		class iterator {
+			bucket_t::const_iterator it;
+
+		public:
+			explicit iterator(bucket_t::const_iterator it)
+				: it(it) {}
+			T& operator*() const { return **it; }
+			iterator& operator++()
+			{
+				++it;
+				return *this;
+			}
+			bool operator!=(const iterator& other) const { return it != other.it; }
+		};
+
+		explicit OpcodeView(const bucket_t& bucket)
+			: bucket(&bucket) {}
+		iterator begin() const { return iterator(bucket->begin()); }
+		iterator end() const { return iterator(bucket->end()); }
+	};
+
+	void Unindex(const Effect* fx);
+	void RebuildIndex();
+
 public:
 	EffectQueue() noexcept {};
+	EffectQueue(const EffectQueue& other);
+	EffectQueue(EffectQueue&&) = default;
+	EffectQueue& operator=(const EffectQueue& other);
+	EffectQueue& operator=(EffectQueue&&) = default;
 
 	explicit operator bool() const
 	{
@@ -238,6 +296,10 @@ public:
 
 	int AddAllEffects(Actor* target, const Point& dest);
 	void ApplyAllEffects(Actor* target);
+	/** Describes the queue for caching the outcome of ApplyAllEffects. Returns false if
+	 * that isn't possible, because an effect is not EFFECT_STAT_ONLY or it is due to
+	 * trigger or expire by gameTime. */
+	bool GetReplayKeys(std::vector<EffectReplayKey>& keys, ieDword gameTime) const;
 	/** remove effects marked for removal */
 	void Cleanup();
 
@@ -296,6 +358,9 @@ public:
 	/* returns the number of saved effects */
 	ieDword GetSavedEffectsCount() const;
 	size_t GetEffectsCount() const { return effects.size(); }
+	/* the effects filed under this opcode, in queue order */
+	OpcodeView<Effect> EffectsWithOpcode(ieDword opcode);
+	OpcodeView<const Effect> EffectsWithOpcode(ieDword opcode) const;
 	unsigned int GetEffectOrder(EffectRef& effectReference, const Effect* fx2) const;
 	/* this method hacks the offhand weapon color effects */
 	static void HackColorEffects(const Actor* Owner, Effect* fx);
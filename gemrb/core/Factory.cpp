@@ -22,30 +22,27 @@
 
 namespace GemRB {
 
-void Factory::AddFactoryObject(object_t fobject)
+void Factory::SetBudget(CacheBudget* budget)
 {
-	fobjects.push_back(std::move(fobject));
+	fobjects.SetBudget(budget);
 }
 
-int Factory::IsLoaded(const ResRef& resref, SClass_ID type) const
+Factory::object_t Factory::AddFactoryObject(object_t fobject, bool reloadable)
 {
-	if (resref.IsEmpty()) {
-		return -1;
-	}
-
-	for (unsigned int i = 0; i < fobjects.size(); i++) {
-		if (fobjects[i]->SuperClassID == type) {
-			if (fobjects[i]->resRef == resref) {
-				return i;
-			}
-		}
-	}
-	return -1;
+	Key key { fobject->resRef, fobject->SuperClassID };
+	size_t size = fobject->GetDataSize();
+	return fobjects.Set(key, std::move(fobject), size, reloadable);
 }
 
-Factory::object_t Factory::GetFactoryObject(int pos) const
+Factory::object_t Factory::GetFactoryObject(const ResRef& resRef, SClass_ID type)
 {
-	return fobjects[pos];
+	if (resRef.IsEmpty()) {
+		return nullptr;
+	}
+
+	object_t cached;
+	fobjects.Find({ resRef, type }, cached);
+	return cached;
 }
 
 }
@@ -23,6 +23,7 @@
 
 #include "exports.h"
 
+#include "Cache.h"
 #include "FactoryObject.h"
 
 #include <memory>
@@ -37,12 +38,31 @@ public:
 	Factory(const Factory&) = delete;
 	Factory& operator=(const Factory&) = delete;
 
-	void AddFactoryObject(object_t fobject);
-	int IsLoaded(const ResRef& resRef, SClass_ID type) const;
-	object_t GetFactoryObject(int pos) const;
+	void SetBudget(CacheBudget* budget);
+	// reloadable objects may be dropped once unused, if the budget needs the room
+	// returns the handle to use from then on, the cache can't tell when other references go away
+	object_t AddFactoryObject(object_t fobject, bool reloadable = false);
+	object_t GetFactoryObject(const ResRef& resRef, SClass_ID type);
 
 private:
-	std::vector<object_t> fobjects;
+	struct Key {
+		ResRef resRef;
+		SClass_ID type;
+
+		bool operator==(const Key& other) const noexcept
+		{
+			return type == other.type && resRef == other.resRef;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const noexcept
+		{
+			return CstrHashCI()(key.resRef) ^ key.type;
+		}
+	};
+
+	SharedCache<Key, FactoryObject, KeyHash> fobjects;
 };
 
 }
@@ -36,6 +36,9 @@ public:
 	FactoryObject(const ResRef& name, SClass_ID superClassID)
 		: SuperClassID(superClassID), resRef(name) {};
 	virtual ~FactoryObject() noexcept = default;
+
+	// rough estimate of the memory held, for cache accounting
+	virtual size_t GetDataSize() const { return sizeof(FactoryObject); }
 };
 
 }
@@ -1489,6 +1489,9 @@ void GameControl::DebugPaint(const Point& p, bool sample) const noexcept
 			DebugPropVal = map->tileProps.QueryTileProp(tile, prop);
 		} else {
 			map->tileProps.SetTileProp(tile, prop, DebugPropVal);
+			if (prop == TileProps::Property::SEARCH_MAP) {
+				map->InvalidateSearchMap(Region(tile.x, tile.y, 1, 1));
+			}
 		}
 	}
 }
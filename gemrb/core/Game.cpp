@@ -83,7 +83,7 @@ struct Injured {
 #define MAX_MAPS_LOADED 1
 
 Game::Game(void)
-	: Scriptable(ST_GLOBAL)
+	: Scriptable(ST_GLOBAL), scriptScheduler(core->config.ScriptBudget)
 {
 	SetScript(core->GlobalScript, 0);
 	weather = new Particles(200);
@@ -906,6 +906,7 @@ int Game::LoadMap(const ResRef& resRef, bool loadscreen)
 	}
 
 	core->GetAudioDrv()->SetReverbProperties(newMap->GetReverbProperties());
+	newMap->PrefetchSounds();
 
 	core->LoadProgress(100);
 	return ret;
@@ -1600,6 +1601,7 @@ static bool ShouldChangeSong(bool combatChange)
 // runs all area scripts
 void Game::UpdateScripts()
 {
+	scriptScheduler.NewTick();
 	Update();
 
 	PartyAttack = false;
@@ -2389,6 +2391,10 @@ std::string Game::dump() const
 	int hours = GameTime / core->Time.hour_size;
 	AppendFormat(buffer, "Game time: {} ({} days, {} hours)\n", GameTime.load(), hours / 24, hours % 24);
 	AppendFormat(buffer, "CombatCounter: {}\n", CombatCounter);
+	const ScriptScheduler::Stats& scriptStats = scriptScheduler.GetStats();
+	AppendFormat(buffer, "Script rounds deferred (on-screen/triggered/idle): {}/{}/{}, forced when overdue: {}\n",
+		     scriptStats.deferred[ScriptScheduler::Priority::OnScreen], scriptStats.deferred[ScriptScheduler::Priority::Triggered],
+		     scriptStats.deferred[ScriptScheduler::Priority::Idle], scriptStats.overdue);
 
 	AppendFormat(buffer, "Party size: {}\n", PCs.size());
 	for (const auto& actor : PCs) {
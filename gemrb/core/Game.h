@@ -32,6 +32,7 @@
 #include "ie_types.h"
 
 #include "Callback.h"
+#include "ScriptScheduler.h"
 
 #include "Scriptable/Scriptable.h"
 
@@ -302,6 +303,8 @@ public:
 	bool familiarBlock = false;
 	bool PartyAttack = false;
 	bool HOFMode = false;
+	// budget for the script rounds of all the loaded areas
+	ScriptScheduler scriptScheduler;
 
 private:
 	/** reads the challenge rating table */
@@ -51,9 +51,42 @@ namespace GemRB {
 
 GEM_EXPORT GameData* gamedata;
 
+static size_t ItemSize(const Item& item)
+{
+	size_t size = sizeof(Item) + item.equipping_features.size() * (sizeof(Effect*) + sizeof(Effect));
+	for (const auto& header : item.ext_headers) {
+		size += sizeof(ITMExtHeader) + header.features.size() * (sizeof(Effect*) + sizeof(Effect));
+	}
+	return size;
+}
+
+static size_t SpellSize(const Spell& spell)
+{
+	size_t size = sizeof(Spell) + spell.casting_features.size() * sizeof(Effect);
+	for (const auto& header : spell.ext_headers) {
+		size += sizeof(SPLExtHeader) + header.features.size() * sizeof(Effect);
+	}
+	return size;
+}
+
+static size_t EffectSize(const Effect&)
+{
+	return sizeof(Effect);
+}
+
+GameData::GameData()
+	: cacheBudget(size_t(std::max(core->config.ResourceCacheMB, 0)) * 1024 * 1024)
+{
+	ItemCache.SetBudget(&cacheBudget, ItemSize);
+	SpellCache.SetBudget(&cacheBudget, SpellSize);
+	EffectCache.SetBudget(&cacheBudget, EffectSize);
+	PaletteCache.SetBudget(&cacheBudget);
+	factory.SetBudget(&cacheBudget);
+}
+
 GameData::~GameData()
 {
-	PaletteCache.clear();
+	PaletteCache.Clear();
 
 	while (!stores.empty()) {
 		Store* store = stores.begin()->second;
@@ -141,20 +174,19 @@ AutoTable GameData::LoadTable(const ResRef& tableRef, bool silent)
 
 Holder<Palette> GameData::GetPalette(const ResRef& resname)
 {
-	auto iter = PaletteCache.find(resname);
-	if (iter != PaletteCache.end())
-		return iter->second;
+	Holder<Palette> cached;
+	if (PaletteCache.Find(resname, cached))
+		return cached;
 
 	ResourceHolder<ImageMgr> im = GetResourceHolder<ImageMgr>(resname);
 	if (im == nullptr) {
-		PaletteCache[resname] = nullptr;
+		PaletteCache.Set(resname, nullptr, 0);
 		return NULL;
 	}
 
 	Holder<Palette> palette = MakeHolder<Palette>(true);
 	im->GetPalette(256, *palette);
-	PaletteCache[resname] = palette;
-	return palette;
+	return PaletteCache.Set(resname, std::move(palette), sizeof(Palette));
 }
 
 Item* GameData::GetItem(const ResRef& resname, bool silent)
@@ -220,7 +252,8 @@ void GameData::FreeSpell(const Spell* /*spl*/, const ResRef& name, bool free)
 
 Effect* GameData::GetEffect(const ResRef& resname)
 {
-	const Effect* effect = EffectCache.GetResource(resname);
+	// only copies are handed out, so the cached original never needs a reference
+	const Effect* effect = EffectCache.Peek(resname);
 	if (effect) {
 		return new Effect(*effect);
 	}
@@ -240,6 +273,7 @@ Effect* GameData::GetEffect(const ResRef& resname)
 	}
 
 	EffectCache.SetAt(resname, *newEffect);
+	EffectCache.DecRef(resname, true);
 
 	auto effectCopy = new Effect(std::move(*newEffect));
 	delete newEffect;
@@ -330,8 +364,8 @@ Factory::object_t GameData::GetFactoryResource(const ResRef& resName, SClass_ID
 	if (resName.IsEmpty()) return nullptr;
 
 	// already cached?
-	int objectIndex = factory.IsLoaded(resName, type);
-	if (objectIndex != -1) return factory.GetFactoryObject(objectIndex);
+	auto cached = factory.GetFactoryObject(resName, type);
+	if (cached) return cached;
 
 	switch (type) {
 		case IE_BAM_CLASS_ID:
@@ -344,8 +378,7 @@ Factory::object_t GameData::GetFactoryResource(const ResRef& resName, SClass_ID
 					}
 
 					auto af = importer->GetAnimationFactory(resName);
-					factory.AddFactoryObject(af);
-					return af;
+					return factory.AddFactoryObject(std::move(af), true);
 				}
 				return NULL;
 			}
@@ -354,8 +387,7 @@ Factory::object_t GameData::GetFactoryResource(const ResRef& resName, SClass_ID
 				ResourceHolder<ImageMgr> img = GetResourceHolder<ImageMgr>(resName, silent);
 				if (img) {
 					auto fact = img->GetImageFactory(resName);
-					factory.AddFactoryObject(fact);
-					return fact;
+					return factory.AddFactoryObject(std::move(fact), true);
 				}
 
 				return NULL;
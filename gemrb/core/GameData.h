@@ -89,7 +89,7 @@ struct ItemUseType {
 
 class GEM_EXPORT GameData : public ResourceManager {
 public:
-	GameData() = default;
+	GameData();
 	GameData(const GameData&) = delete;
 	GameData& operator=(const GameData&) = delete;
 	~GameData();
@@ -199,10 +199,11 @@ private:
 	void ReadSpellProtTable();
 
 private:
+	CacheBudget cacheBudget; // must outlive the caches below
 	ResRefRCCache<Item> ItemCache;
 	ResRefRCCache<Spell> SpellCache;
 	ResRefRCCache<Effect> EffectCache;
-	ResRefMap<Holder<Palette>> PaletteCache;
+	SharedCache<ResRef, Palette, CstrHashCI> PaletteCache;
 	Factory factory;
 	ResRefMap<AutoTable> tables;
 	using StoreMap = ResRefMap<Store*>;
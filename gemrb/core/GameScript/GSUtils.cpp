@@ -1714,7 +1714,7 @@ bool IsInObjectRect(const Point& pos, const Region& rect)
 	}
 }
 
-static Object* ObjectCopy(const Object* object)
+Object* ObjectCopy(const Object* object)
 {
 	if (!object) return nullptr;
 	Object* newObject = new Object();
@@ -1741,6 +1741,21 @@ Action* ParamCopy(const Action* parameters)
 	return newAction;
 }
 
+Trigger* TriggerCopy(const Trigger* parameters)
+{
+	Trigger* newTrigger = new Trigger();
+	newTrigger->triggerID = parameters->triggerID;
+	newTrigger->flags = parameters->flags;
+	newTrigger->int0Parameter = parameters->int0Parameter;
+	newTrigger->int1Parameter = parameters->int1Parameter;
+	newTrigger->int2Parameter = parameters->int2Parameter;
+	newTrigger->pointParameter = parameters->pointParameter;
+	newTrigger->string0Parameter = parameters->string0Parameter;
+	newTrigger->string1Parameter = parameters->string1Parameter;
+	newTrigger->objectParameter = ObjectCopy(parameters->objectParameter);
+	return newTrigger;
+}
+
 Action* ParamCopyNoOverride(const Action* parameters)
 {
 	Action* newAction = new Action(true);
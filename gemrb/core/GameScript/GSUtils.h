@@ -127,7 +127,9 @@ GEM_EXPORT Actor* GetNearestEnemyOf(const Map* map, const Actor* origin, int who
 GEM_EXPORT void FreeSrc(const SrcVector* poi, const ResRef& key);
 GEM_EXPORT SrcVector* LoadSrc(const ResRef& resname);
 bool IsInObjectRect(const Point& pos, const Region& rect);
+Object* ObjectCopy(const Object* object);
 Action* ParamCopy(const Action* parameters);
+Trigger* TriggerCopy(const Trigger* parameters);
 Action* ParamCopyNoOverride(const Action* parameters);
 GEM_EXPORT void SetVariable(Scriptable* Sender, const StringParam& VarName, ieDword value, VarContext Context = {});
 GEM_EXPORT void SetPointVariable(Scriptable* Sender, const StringParam& VarName, const Point& point, const VarContext& Context = {});
@@ -54,6 +54,8 @@
 #include "GameScript/GSUtils.h"
 #include "GameScript/Matching.h"
 
+#include <algorithm>
+
 namespace GemRB {
 
 //debug flags
@@ -90,9 +92,9 @@ static const TriggerLink triggernames[] = {
 	{ "attackedby", GameScript::AttackedBy, 0 },
 	{ "becamevisible", GameScript::BecameVisible, 0 },
 	{ "beeninparty", GameScript::BeenInParty, 0 },
-	{ "bitcheck", GameScript::BitCheck, TF_MERGESTRINGS },
-	{ "bitcheckexact", GameScript::BitCheckExact, TF_MERGESTRINGS },
-	{ "bitglobal", GameScript::BitGlobal_Trigger, TF_MERGESTRINGS },
+	{ "bitcheck", GameScript::BitCheck, TF_MERGESTRINGS | TF_PURE },
+	{ "bitcheckexact", GameScript::BitCheckExact, TF_MERGESTRINGS | TF_PURE },
+	{ "bitglobal", GameScript::BitGlobal_Trigger, TF_MERGESTRINGS | TF_PURE },
 	{ "bouncingspelllevel", GameScript::BouncingSpellLevel, 0 },
 	{ "breakingpoint", GameScript::BreakingPoint, 0 },
 	{ "buttondisabled", GameScript::ButtonDisabled, 0 },
@@ -162,29 +164,29 @@ static const TriggerLink triggernames[] = {
 	{ "failedtoopen", GameScript::OpenFailed, 0 },
 	{ "fallenpaladin", GameScript::FallenPaladin, 0 },
 	{ "fallenranger", GameScript::FallenRanger, 0 },
-	{ "false", GameScript::False, 0 },
+	{ "false", GameScript::False, TF_PURE },
 	{ "forcemarkedspell", GameScript::ForceMarkedSpell_Trigger, 0 },
 	{ "frame", GameScript::Frame, 0 },
 	{ "g", GameScript::G_Trigger, 0 },
 	{ "gender", GameScript::Gender, 0 },
 	{ "general", GameScript::General, 0 },
-	{ "ggt", GameScript::GGT_Trigger, 0 },
-	{ "glt", GameScript::GLT_Trigger, 0 },
-	{ "global", GameScript::Global, TF_MERGESTRINGS },
-	{ "globalandglobal", GameScript::GlobalAndGlobal_Trigger, TF_MERGESTRINGS },
-	{ "globalband", GameScript::BitCheck, TF_MERGESTRINGS },
-	{ "globalbandglobal", GameScript::GlobalBAndGlobal_Trigger, TF_MERGESTRINGS },
-	{ "globalbandglobalexact", GameScript::GlobalBAndGlobalExact, TF_MERGESTRINGS },
-	{ "globalbitglobal", GameScript::GlobalBitGlobal_Trigger, TF_MERGESTRINGS },
-	{ "globalequalsglobal", GameScript::GlobalsEqual, TF_MERGESTRINGS }, //this is the same
-	{ "globalgt", GameScript::GlobalGT, TF_MERGESTRINGS },
-	{ "globalgtglobal", GameScript::GlobalGTGlobal, TF_MERGESTRINGS },
-	{ "globallt", GameScript::GlobalLT, TF_MERGESTRINGS },
-	{ "globalltglobal", GameScript::GlobalLTGlobal, TF_MERGESTRINGS },
-	{ "globalorglobal", GameScript::GlobalOrGlobal_Trigger, TF_MERGESTRINGS },
-	{ "globalsequal", GameScript::GlobalsEqual, 0 },
-	{ "globalsgt", GameScript::GlobalsGT, 0 },
-	{ "globalslt", GameScript::GlobalsLT, 0 },
+	{ "ggt", GameScript::GGT_Trigger, TF_PURE },
+	{ "glt", GameScript::GLT_Trigger, TF_PURE },
+	{ "global", GameScript::Global, TF_MERGESTRINGS | TF_PURE },
+	{ "globalandglobal", GameScript::GlobalAndGlobal_Trigger, TF_MERGESTRINGS | TF_PURE },
+	{ "globalband", GameScript::BitCheck, TF_MERGESTRINGS | TF_PURE },
+	{ "globalbandglobal", GameScript::GlobalBAndGlobal_Trigger, TF_MERGESTRINGS | TF_PURE },
+	{ "globalbandglobalexact", GameScript::GlobalBAndGlobalExact, TF_MERGESTRINGS | TF_PURE },
+	{ "globalbitglobal", GameScript::GlobalBitGlobal_Trigger, TF_MERGESTRINGS | TF_PURE },
+	{ "globalequalsglobal", GameScript::GlobalsEqual, TF_MERGESTRINGS | TF_PURE }, //this is the same
+	{ "globalgt", GameScript::GlobalGT, TF_MERGESTRINGS | TF_PURE },
+	{ "globalgtglobal", GameScript::GlobalGTGlobal, TF_MERGESTRINGS | TF_PURE },
+	{ "globallt", GameScript::GlobalLT, TF_MERGESTRINGS | TF_PURE },
+	{ "globalltglobal", GameScript::GlobalLTGlobal, TF_MERGESTRINGS | TF_PURE },
+	{ "globalorglobal", GameScript::GlobalOrGlobal_Trigger, TF_MERGESTRINGS | TF_PURE },
+	{ "globalsequal", GameScript::GlobalsEqual, TF_PURE },
+	{ "globalsgt", GameScript::GlobalsGT, TF_PURE },
+	{ "globalslt", GameScript::GlobalsLT, TF_PURE },
 	{ "globaltimerexact", GameScript::GlobalTimerExact, 0 },
 	{ "globaltimerexpired", GameScript::GlobalTimerExpired, 0 },
 	{ "globaltimernotexpired", GameScript::GlobalTimerNotExpired, 0 },
@@ -296,9 +298,9 @@ static const TriggerLink triggernames[] = {
 	{ "levelparty", GameScript::LevelParty, 0 },
 	{ "levelpartygt", GameScript::LevelPartyGT, 0 },
 	{ "levelpartylt", GameScript::LevelPartyLT, 0 },
-	{ "localsequal", GameScript::LocalsEqual, 0 },
-	{ "localsgt", GameScript::LocalsGT, 0 },
-	{ "localslt", GameScript::LocalsLT, 0 },
+	{ "localsequal", GameScript::LocalsEqual, TF_PURE },
+	{ "localsgt", GameScript::LocalsGT, TF_PURE },
+	{ "localslt", GameScript::LocalsLT, TF_PURE },
 	{ "los", GameScript::LOS, 0 },
 	{ "lt", GameScript::LT, 0 },
 	{ "modalstate", GameScript::ModalState, 0 },
@@ -323,15 +325,15 @@ static const TriggerLink triggernames[] = {
 	{ "numbouncingspelllevel", GameScript::NumBouncingSpellLevel, 0 },
 	{ "numbouncingspelllevelgt", GameScript::NumBouncingSpellLevelGT, 0 },
 	{ "numbouncingspelllevellt", GameScript::NumBouncingSpellLevelLT, 0 },
-	{ "numcreature", GameScript::NumCreatures, 0 },
-	{ "numcreaturegt", GameScript::NumCreaturesGT, 0 },
-	{ "numcreaturelt", GameScript::NumCreaturesLT, 0 },
+	{ "numcreature", GameScript::NumCreatures, TF_PURE | TF_COSTLY },
+	{ "numcreaturegt", GameScript::NumCreaturesGT, TF_PURE | TF_COSTLY },
+	{ "numcreaturelt", GameScript::NumCreaturesLT, TF_PURE | TF_COSTLY },
 	{ "numcreaturesatmylevel", GameScript::NumCreaturesAtMyLevel, 0 },
 	{ "numcreaturesgtmylevel", GameScript::NumCreaturesGTMyLevel, 0 },
 	{ "numcreaturesltmylevel", GameScript::NumCreaturesLTMyLevel, 0 },
-	{ "numcreaturevsparty", GameScript::NumCreatureVsParty, 0 },
-	{ "numcreaturevspartygt", GameScript::NumCreatureVsPartyGT, 0 },
-	{ "numcreaturevspartylt", GameScript::NumCreatureVsPartyLT, 0 },
+	{ "numcreaturevsparty", GameScript::NumCreatureVsParty, TF_PURE | TF_COSTLY },
+	{ "numcreaturevspartygt", GameScript::NumCreatureVsPartyGT, TF_PURE | TF_COSTLY },
+	{ "numcreaturevspartylt", GameScript::NumCreatureVsPartyLT, TF_PURE | TF_COSTLY },
 	{ "numdead", GameScript::NumDead, 0 },
 	{ "numdeadgt", GameScript::NumDeadGT, 0 },
 	{ "numdeadlt", GameScript::NumDeadLT, 0 },
@@ -475,7 +477,7 @@ static const TriggerLink triggernames[] = {
 	{ "trigger", GameScript::TriggerTrigger, 0 },
 	{ "triggerclick", GameScript::Clicked, 0 }, //not sure
 	{ "triggersetglobal", GameScript::TriggerSetGlobal, 0 }, //iwd2, but never used
-	{ "true", GameScript::True, 0 },
+	{ "true", GameScript::True, TF_PURE },
 	{ "turnedby", GameScript::TurnedBy, 0 },
 	{ "unlocked", GameScript::Unlocked, 0 },
 	{ "unselectablevariable", GameScript::UnselectableVariable, 0 },
@@ -488,7 +490,7 @@ static const TriggerLink triggernames[] = {
 	{ "wasindialog", GameScript::WasInDialog, 0 },
 	{ "weaponcandamage", GameScript::WeaponCanDamage, 0 },
 	{ "weaponeffectivevs", GameScript::WeaponEffectiveVs, 0 },
-	{ "xor", GameScript::Xor, TF_MERGESTRINGS },
+	{ "xor", GameScript::Xor, TF_MERGESTRINGS | TF_PURE },
 	{ "xp", GameScript::XP, 0 },
 	{ "xpgt", GameScript::XPGT, 0 },
 	{ "xplt", GameScript::XPLT, 0 },
@@ -2010,11 +2012,9 @@ int GameScript::EvaluateString(Scriptable* Sender, const char* String)
 	if (String[0] == 0) {
 		return 0;
 	}
-	Trigger* tri = GenerateTrigger(String);
+	auto tri = CompileTrigger(String);
 	if (tri) {
-		int ret = tri->Evaluate(Sender);
-		tri->Release();
-		return ret;
+		return tri->Evaluate(Sender);
 	}
 	return 0;
 }
@@ -2065,6 +2065,44 @@ bool Condition::Evaluate(Scriptable* Sender) const
 	return true;
 }
 
+static bool IsPureTrigger(const Trigger* tR)
+{
+	return tR->triggerID < MAX_TRIGGERS && (triggerflags[tR->triggerID] & TF_PURE);
+}
+
+static bool IsCostlyTrigger(const Trigger* tR)
+{
+	return triggerflags[tR->triggerID] & TF_COSTLY;
+}
+
+// only runs of side effect free triggers outside Or() blocks are touched,
+// so the same triggers get evaluated with the same results, just sooner
+void Condition::ReorderTriggers()
+{
+	if (!core->config.ReorderTriggers) return;
+
+	auto run = triggers.begin();
+	int ORcount = 0;
+	bool retargeted = false;
+	for (auto it = triggers.begin(); it != triggers.end(); ++it) {
+		const Trigger* tR = *it;
+		// NextTriggerObject applies to whatever comes right after it
+		bool movable = !ORcount && !retargeted && IsPureTrigger(tR);
+		retargeted = NextTriggerObjectID && tR->triggerID == NextTriggerObjectID;
+		if (ORcount) {
+			--ORcount;
+		} else if (tR->triggerID < MAX_TRIGGERS && GemRB::triggers[tR->triggerID] == GameScript::Or) {
+			ORcount = std::max(tR->int0Parameter, 0);
+		}
+
+		if (!movable) {
+			std::stable_partition(run, it, [](const Trigger* t) { return !IsCostlyTrigger(t); });
+			run = it + 1;
+		}
+	}
+	std::stable_partition(run, triggers.end(), [](const Trigger* t) { return !IsCostlyTrigger(t); });
+}
+
 /* this may return more than a boolean, in case of Or(x) */
 int Trigger::Evaluate(Scriptable* Sender) const
 {
@@ -31,6 +31,7 @@
 #include "Streams/DataStream.h"
 
 #include <cstdio>
+#include <memory>
 #include <vector>
 
 namespace GemRB {
@@ -214,6 +215,8 @@ public:
 		delete this;
 	}
 	bool Evaluate(Scriptable* Sender) const;
+	// moves cheap triggers ahead of costly ones, where that can't change the outcome
+	void ReorderTriggers();
 
 	std::vector<Trigger*> triggers;
 };
@@ -391,6 +394,8 @@ using IDSFunction = int (*)(const Actor*, int parameter);
 #define TF_SAVED        2 //trigger is in svtriobj.ids
 #define TF_MERGESTRINGS 8 //same value as actions' mergestring
 #define TF_HAS_OBJECT   16 // whether it has an object parameter
+#define TF_PURE         32 // no side effects, so it can be moved around in a condition
+#define TF_COSTLY       64 // scans the area, better evaluated late
 
 struct TriggerLink {
 	const char* Name;
@@ -533,6 +538,9 @@ public: //Script Functions
 	static int ID_Specific(const Actor* actor, int parameter);
 	static int ID_Subrace(const Actor* actor, int parameter);
 	static int ID_Team(const Actor* actor, int parameter);
+	// the stat comparisons behind the above, for callers that only have the value
+	static bool MatchAlignment(int value, int parameter);
+	static bool MatchAllegiance(int value, int parameter);
 
 	//Triggers
 	static int ActionListEmpty(Scriptable* Sender, const Trigger* parameters);
@@ -1579,6 +1587,8 @@ public: //Script Functions
 GEM_EXPORT Action* GenerateAction(std::string String);
 GEM_EXPORT Action* GenerateActionDirect(std::string string, const Scriptable* object);
 GEM_EXPORT Trigger* GenerateTrigger(std::string string);
+// the shared compiled form, for callers that only evaluate it
+GEM_EXPORT std::shared_ptr<const Trigger> CompileTrigger(std::string string);
 
 void InitializeIEScript();
 
@@ -66,6 +66,61 @@ static inline bool DoObjectIDSCheck(const Object* oC, const Actor* ac, bool* fil
 	return true;
 }
 
+/* the stat an IDS targeting function compares, so the area index can be used */
+static bool IndexedIDS(IDSFunction func, int parameter, unsigned int& stat, ActorStatIndex::Filter& accept)
+{
+	if (func == GameScript::ID_Allegiance) {
+		stat = IE_EA;
+		accept = [parameter](ieDword value) { return GameScript::MatchAllegiance(value, parameter); };
+		return true;
+	}
+	if (func == GameScript::ID_Alignment) {
+		stat = IE_ALIGNMENT;
+		accept = [parameter](ieDword value) { return GameScript::MatchAlignment(value, parameter); };
+		return true;
+	}
+
+	// class is left out, since it depends on the levels and the active class too
+	if (func == GameScript::ID_General) {
+		stat = IE_GENERAL;
+	} else if (func == GameScript::ID_Race) {
+		stat = IE_RACE;
+	} else if (func == GameScript::ID_Specific) {
+		stat = IE_SPECIFIC;
+	} else if (func == GameScript::ID_Gender) {
+		stat = IE_SEX;
+	} else {
+		return false;
+	}
+	accept = [parameter](ieDword value) { return int(value) == parameter; };
+	return true;
+}
+
+/* the actors that can pass DoObjectIDSCheck, from the smallest matching index bucket */
+static bool GetIDSCandidates(const Map* map, const Object* oC, std::vector<Actor*>& candidates)
+{
+	bool narrowed = false;
+	std::vector<Actor*> found;
+	for (int j = 0; j < ObjectIDSCount; j++) {
+		if (!oC->objectFields[j] || !idtargets[j]) {
+			continue;
+		}
+		unsigned int stat;
+		ActorStatIndex::Filter accept;
+		if (!IndexedIDS(idtargets[j], oC->objectFields[j], stat, accept)) {
+			continue;
+		}
+		if (!map->GetActorsByStat(stat, accept, found)) {
+			continue;
+		}
+		if (!narrowed || found.size() < candidates.size()) {
+			candidates.swap(found);
+			narrowed = true;
+		}
+	}
+	return narrowed;
+}
+
 /* do object filtering: Myself, LastAttackerOf(Player1), etc */
 static inline Targets* DoObjectFiltering(const Scriptable* Sender, Targets* tgts, const Object* oC, int ga_flags)
 {
@@ -198,11 +253,14 @@ static Targets* EvaluateObject(const Map* map, const Scriptable* Sender, const O
 
 	Targets* tgts = NULL;
 
-	//we need to get a subset of actors from the large array
-	//if this gets slow, we will need some index tables
-	int i = map->GetActorCount(true);
+	// we need to get a subset of actors from the large array
+	// the full checks still run, the index only skips the hopeless ones
+	std::vector<Actor*> candidates;
+	bool narrowed = GetIDSCandidates(map, oC, candidates);
+	const std::vector<Actor*>& actors = narrowed ? candidates : map->GetAllActors();
+	size_t i = actors.size();
 	while (i--) {
-		Actor* ac = map->GetActor(i, true);
+		Actor* ac = actors[i];
 		if (!ac) continue; // is this check really needed?
 		// don't return Sender in IDS targeting!
 		// unless it's pst, which relies on it in 3012cut2-3012cut7.bcs
@@ -1217,23 +1217,26 @@ Targets* GameScript::Nothing(const Scriptable* /*Sender*/, Targets* parameters,
 // IDS Functions
 //-------------------------------------------------------------
 
-int GameScript::ID_Alignment(const Actor* actor, int parameter)
+bool GameScript::MatchAlignment(int value, int parameter)
 {
-	int value = actor->GetStat(IE_ALIGNMENT);
 	int a = parameter & 15;
 	if (a && a != (value & 15)) {
-		return 0;
+		return false;
 	}
 	a = parameter & 240;
 	if (a && a != (value & 240)) {
-		return 0;
+		return false;
 	}
-	return 1;
+	return true;
 }
 
-int GameScript::ID_Allegiance(const Actor* actor, int parameter)
+int GameScript::ID_Alignment(const Actor* actor, int parameter)
+{
+	return MatchAlignment(actor->GetStat(IE_ALIGNMENT), parameter);
+}
+
+bool GameScript::MatchAllegiance(int value, int parameter)
 {
-	int value = actor->GetStat(IE_EA);
 	switch (parameter) {
 		case EA_GOODCUTOFF:
 			return value <= EA_GOODCUTOFF;
@@ -1258,6 +1261,11 @@ int GameScript::ID_Allegiance(const Actor* actor, int parameter)
 	return parameter == value;
 }
 
+int GameScript::ID_Allegiance(const Actor* actor, int parameter)
+{
+	return MatchAllegiance(actor->GetStat(IE_EA), parameter);
+}
+
 // *_ALL constants are different in iwd2 due to different classes (see note below)
 // bard, cleric, druid, fighter, mage, paladin, ranger, thief
 static const int all_bg_classes[] = { 206, 204, 208, 203, 202, 207, 209, 205 };
@@ -191,6 +191,7 @@ static Condition* ReadCondition(DataStream* stream)
 
 		cO->triggers.push_back(tR);
 	}
+	cO->ReorderTriggers();
 	return cO;
 }
 
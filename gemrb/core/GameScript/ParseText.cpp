@@ -23,9 +23,46 @@
 #include "GSUtils.h"
 #include "GameScript.h"
 #include "Interface.h"
+#include "LRUCache.h"
 
 namespace GemRB {
 
+// parsed triggers and actions by their (lowercased) source text, so dialogs
+// and the GUI don't retokenize the same strings over and over
+// callers get copies, since actions are modified while they run
+template<typename T>
+struct CompiledScript {
+	std::shared_ptr<const T> prototype;
+
+	explicit CompiledScript(std::shared_ptr<const T> prototype)
+		: prototype(std::move(prototype)) {}
+	void evictionNotice() const {}
+};
+
+struct EvictOldest {
+	template<typename T>
+	bool operator()(const T&) const { return true; }
+};
+
+static LRUCache<CompiledScript<Trigger>, EvictOldest> compiledTriggers { 1024 };
+static LRUCache<CompiledScript<Action>, EvictOldest> compiledActions { 1024 };
+
+template<typename T, typename PARSER>
+static std::shared_ptr<const T> Compile(LRUCache<CompiledScript<T>, EvictOldest>& cache, const std::string& source, PARSER parse)
+{
+	const CompiledScript<T>* compiled = cache.Lookup(source);
+	if (compiled) {
+		cache.Touch(source);
+		return compiled->prototype;
+	}
+
+	std::shared_ptr<const T> prototype(parse(source));
+	if (prototype) {
+		cache.SetAt(source, prototype);
+	}
+	return prototype;
+}
+
 
 // we need this because some special characters like _ or * are also accepted
 inline bool IsMySymbol(const char letter)
@@ -485,9 +522,8 @@ Trigger* GenerateTriggerCore(const char* src, const char* str, int trIndex, int
 	return newTrigger;
 }
 
-Trigger* GenerateTrigger(std::string string)
+static Trigger* ParseTrigger(const std::string& string)
 {
-	StringToLower(string);
 	ScriptDebugLog(DebugMode::TRIGGERS, "Compiling: '{}'", string);
 
 	int negate = 0;
@@ -513,11 +549,22 @@ Trigger* GenerateTrigger(std::string string)
 	return trigger;
 }
 
-Action* GenerateAction(std::string actionString)
+std::shared_ptr<const Trigger> CompileTrigger(std::string string)
+{
+	StringToLower(string);
+	return Compile(compiledTriggers, string, ParseTrigger);
+}
+
+Trigger* GenerateTrigger(std::string string)
+{
+	auto trigger = CompileTrigger(std::move(string));
+	return trigger ? TriggerCopy(trigger.get()) : nullptr;
+}
+
+static Action* ParseAction(const std::string& actionString)
 {
 	Action* action = nullptr;
 
-	StringToLower(actionString);
 	ScriptDebugLog(DebugMode::ACTIONS, "Compiling: '{}'", actionString);
 
 	auto len = actionString.find_first_of('(') + 1; //including (
@@ -555,6 +602,17 @@ Action* GenerateAction(std::string actionString)
 	return action;
 }
 
+Action* GenerateAction(std::string actionString)
+{
+	StringToLower(actionString);
+	auto prototype = Compile(compiledActions, actionString, ParseAction);
+	if (!prototype) return nullptr;
+
+	Action* action = ParamCopy(prototype.get());
+	action->flags = prototype->flags;
+	return action;
+}
+
 Action* GenerateActionDirect(std::string string, const Scriptable* object)
 {
 	Action* action = GenerateAction(std::move(string));
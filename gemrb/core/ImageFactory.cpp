@@ -29,4 +29,13 @@ ImageFactory::ImageFactory(const ResRef& resref, Holder<Sprite2D> bitmap_)
 {
 }
 
+size_t ImageFactory::GetDataSize() const
+{
+	size_t size = sizeof(ImageFactory);
+	if (bitmap) {
+		size += sizeof(Sprite2D) + size_t(bitmap->GetPitch()) * bitmap->Frame.h;
+	}
+	return size;
+}
+
 }
@@ -52,6 +52,7 @@
 #include "SaveGameIterator.h"
 #include "SaveGameMgr.h"
 #include "ScriptedAnimation.h"
+#include "SubsystemTimer.h"
 #include "SymbolMgr.h"
 #include "TileMap.h"
 #include "WorldMapMgr.h"
@@ -68,6 +69,9 @@
 #include "Streams/FileStream.h"
 #include "System/FileFilters.h"
 #include "Video/Video.h"
+#if defined(SUPPORTS_MEMSTREAM)
+	#include "Streams/MappedFileMemoryStream.h"
+#endif
 
 #include <utility>
 #include <vector>
@@ -90,6 +94,19 @@ static void ThrowException(const std::string& msg)
 	throw CIE(msg);
 }
 
+// the string tables are read from all over, so keep them mapped when possible
+static DataStream* OpenStringTable(const path_t& path)
+{
+#if defined(SUPPORTS_MEMSTREAM)
+	auto mapped = new MappedFileMemoryStream { path };
+	if (mapped->isOk()) {
+		return mapped;
+	}
+	delete mapped;
+#endif
+	return FileStream::OpenFile(path);
+}
+
 struct AbilityTables {
 	using AbilityTable = std::vector<ieWordSigned>;
 
@@ -449,12 +466,12 @@ Interface::Interface(CoreSettings&& cfg)
 	strings = MakePluginHolder<StringMgr>(IE_TLK_CLASS_ID);
 	Log(MESSAGE, "Core", "Loading Dialog.tlk file...");
 	path_t strpath = PathJoin(config.GamePath, "dialog.tlk");
-	FileStream* fs = FileStream::OpenFile(strpath);
+	DataStream* fs = OpenStringTable(strpath);
 
 	if (!fs) {
 		// EE multi language deployment
 		strpath = PathJoin(config.GamePath, config.GameLanguagePath, "dialog.tlk");
-		fs = FileStream::OpenFile(strpath);
+		fs = OpenStringTable(strpath);
 
 		if (!fs) {
 			ThrowException("Cannot find Dialog.tlk.");
@@ -467,11 +484,11 @@ Interface::Interface(CoreSettings&& cfg)
 		strings2 = MakePluginHolder<StringMgr>(IE_TLK_CLASS_ID);
 		Log(MESSAGE, "Core", "Loading DialogF.tlk file...");
 		strpath = PathJoin(config.GamePath, "dialogf.tlk");
-		fs = FileStream::OpenFile(strpath);
+		fs = OpenStringTable(strpath);
 		if (!fs) {
 			// try EE-style paths
 			strpath = PathJoin(config.GamePath, config.GameLanguagePath, "dialogf.tlk");
-			fs = FileStream::OpenFile(strpath);
+			fs = OpenStringTable(strpath);
 		}
 		if (!fs) {
 			Log(ERROR, "Core", "Cannot find DialogF.tlk. Let us know which translation you are using.");
@@ -944,6 +961,12 @@ void Interface::DisableMusicPlaylist(size_t SongType)
 /** this is the main loop */
 void Interface::Main()
 {
+	if (config.BenchmarkTicks > 0) {
+		RunBenchmark();
+		QuitGame(0);
+		return;
+	}
+
 	int speed = vars.Get("Mouse Scroll Speed", 10);
 	SetMouseScrollSpeed(speed + 1);
 
@@ -1011,6 +1034,7 @@ void Interface::Main()
 			GlobalColorCycle.AdvanceTime(time);
 			lastGameUpdate = time;
 		}
+		audioPlayback->Housekeeping();
 
 		winmgr->DrawWindows();
 		if (config.DrawFPS) {
@@ -1030,6 +1054,83 @@ void Interface::Main()
 	QuitGame(0);
 }
 
+/** the main loop without the wall clock, for comparable measurements */
+void Interface::RunBenchmark()
+{
+	// run the start script, it sets up what loading expects
+	while (QuitFlag && QuitFlag != QF_KILL) {
+		HandleFlags();
+	}
+
+	Holder<SaveGame> save = GetSaveGameIterator()->GetSaveGame(StringFromUtf8(config.BenchmarkSave.c_str()));
+	if (!save) {
+		Log(ERROR, "Benchmark", "Save not found: {}", config.BenchmarkSave);
+		return;
+	}
+
+	RNG::getInstance().Seed(config.BenchmarkSeed);
+	// every tick advances the clock by exactly one tick, no matter how long it took
+	const tick_t oneTick = 1000 / Time.ticksPerSec;
+	VirtualMilliseconds = oneTick;
+
+	SetupLoadGame(save, 0);
+	QuitFlag |= QF_ENTERGAME;
+	while (QuitFlag && QuitFlag != QF_KILL) {
+		HandleFlags();
+	}
+	if (!game) {
+		Log(ERROR, "Benchmark", "Unable to load {}!", config.BenchmarkSave);
+		VirtualMilliseconds = 0;
+		return;
+	}
+
+	SubsystemTimer::Reset();
+	SubsystemTimer::Enable(true);
+	Actor::ResetEffectCacheStats();
+	auto start = SubsystemTimer::clock_t::now();
+	int tick = 0;
+	for (; tick < config.BenchmarkTicks && !(QuitFlag & QF_KILL); ++tick) {
+		VirtualMilliseconds += oneTick;
+		while (QuitFlag && QuitFlag != QF_KILL) {
+			HandleFlags();
+		}
+		if (gamectrl) {
+			if (EventFlag) {
+				HandleEvents();
+			}
+			HandleGUIBehaviour(gamectrl);
+		}
+
+		GameLoop();
+		GlobalColorCycle.AdvanceTime(VirtualMilliseconds);
+		audioPlayback->Housekeeping();
+		// drawing still advances animations, the null video driver just skips the blits
+		winmgr->DrawWindows();
+		if (VideoDriver->SwapBuffers(0) != GEM_OK) break;
+	}
+	auto elapsed = SubsystemTimer::clock_t::now() - start;
+	SubsystemTimer::Enable(false);
+	VirtualMilliseconds = 0;
+
+	using ms = std::chrono::duration<double, std::milli>;
+	double total = ms(elapsed).count();
+	Log(MESSAGE, "Benchmark", "{}: {} ticks in {:.1f} ms, {:.3f} ms per tick (seed {})",
+	    config.BenchmarkSave, tick, total, tick ? total / tick : 0.0, config.BenchmarkSeed);
+	const SubsystemTimer::Totals& totals = SubsystemTimer::GetTotals();
+	for (auto subsystem : EnumIterator<SubsystemTimer::Subsystem>()) {
+		double time = ms(totals.time[subsystem]).count();
+		Log(MESSAGE, "Benchmark", "{:>12}: {:10.1f} ms in {:8} calls ({:.1f}%)",
+		    SubsystemTimer::Name(subsystem), time, totals.calls[subsystem], total > 0 ? 100 * time / total : 0.0);
+	}
+	const AudioBufferCache& sounds = audioPlayback->GetBufferCache();
+	const AudioBufferCache::Stats& stats = sounds.GetStats();
+	Log(MESSAGE, "Benchmark", "Sound cache: {} hits, {} misses ({} encoded), {} evictions, {} KiB in use",
+	    stats.hits, stats.misses, stats.encodedHits, stats.evictions, sounds.GetUsage() / 1024);
+	const Actor::EffectCacheStats& fxStats = Actor::GetEffectCacheStats();
+	Log(MESSAGE, "Benchmark", "Effect cache: {} hits, {} misses, {} uncacheable replays",
+	    fxStats.hits, fxStats.misses, fxStats.uncacheable);
+}
+
 void Interface::InitVideo() const
 {
 	Log(MESSAGE, "Core", "Initializing Video Driver...");
@@ -685,6 +685,8 @@ private:
 	GameControl* StartGameControl();
 	/** Executes everything (non graphical) in the main game loop */
 	void GameLoop(void);
+	/** Runs the configured number of ticks of a save headless and reports timings */
+	void RunBenchmark();
 	/** the internal (without cache) part of GetListFrom2DA */
 	std::vector<ieDword> GetListFrom2DAInternal(const ResRef& resref) const;
 
@@ -158,6 +158,8 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 		}
 	};
 
+	CONFIG_INT("BenchmarkSeed", config.BenchmarkSeed);
+	CONFIG_INT("BenchmarkTicks", config.BenchmarkTicks);
 	CONFIG_INT("Bpp", config.Bpp);
 	CONFIG_INT("CaseSensitive", config.CaseSensitive);
 	CONFIG_INT("DoubleClickDelay", config.DoubleClickDelay);
@@ -168,14 +170,21 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 	CONFIG_INT("GCDebug", config.DebugFlags);
 	CONFIG_INT("GUIEnhancements", config.GUIEnhancements);
 	CONFIG_INT("Height", config.Height);
+	CONFIG_INT("HierarchicalPathfinding", config.HierarchicalPathfinding);
 	CONFIG_INT("KeepCache", config.KeepCache);
 	CONFIG_INT("MaxPartySize", config.MaxPartySize);
 	config.MaxPartySize = std::min(std::max(1, config.MaxPartySize), 10);
 	CONFIG_INT("MouseFeedback", config.MouseFeedback);
 	CONFIG_INT("MultipleQuickSaves", config.MultipleQuickSaves);
+	CONFIG_INT("PrewarmArchives", config.PrewarmArchives);
 	CONFIG_INT("UseAsLibrary", config.UseAsLibrary);
+	CONFIG_INT("ReorderTriggers", config.ReorderTriggers);
 	CONFIG_INT("RepeatKeyDelay", config.ActionRepeatDelay);
+	CONFIG_INT("ResourceCacheMB", config.ResourceCacheMB);
+	CONFIG_INT("AudioCacheMB", config.AudioCacheMB);
+	CONFIG_INT("KeepEncodedSounds", config.KeepEncodedSounds);
 	CONFIG_INT("SaveAsOriginal", config.SaveAsOriginal);
+	CONFIG_INT("ScriptBudget", config.ScriptBudget);
 	CONFIG_INT("SpriteFogOfWar", config.SpriteFoW);
 	CONFIG_INT("DebugMode", config.debugMode);
 	CONFIG_INT("TouchInput", config.TouchInput);
@@ -287,6 +296,7 @@ CoreSettings LoadFromDictionary(InterfaceConfig cfg)
 	CONFIG_PATH("SavePath", config.SavePath, config.GamePath);
 
 	CONFIG_STRING("AudioDriver", config.AudioDriverName);
+	CONFIG_STRING("BenchmarkSave", config.BenchmarkSave);
 	CONFIG_STRING("VideoDriver", config.VideoDriverName);
 	CONFIG_STRING("SkipPlugin", config.SkipPlugin);
 	CONFIG_STRING("DelayPlugin", config.DelayPlugin);
@@ -343,6 +353,17 @@ CoreSettings LoadFromArgs(int argc, char* argv[])
 			settings.Set("FullScreen", "1");
 		} else if (stricmp(argv[i], "--color") == 0) {
 			if (i < argc - 1) settings.Set("LogColor", argv[++i]);
+		} else if (stricmp(argv[i], "--benchmark") == 0) {
+			// headless: --benchmark <save slot> <ticks>
+			// without them, we'd just sit in the normal game loop with nothing to show
+			if (i >= argc - 2) {
+				FlushLogs();
+				throw CIE("Usage: --benchmark <save slot> <ticks>");
+			}
+			settings.Set("BenchmarkSave", argv[++i]);
+			settings.Set("BenchmarkTicks", argv[++i]);
+			settings.Set("AudioDriver", "none");
+			settings.Set("VideoDriver", "none");
 		} else {
 			// assume a path was passed, soft force configless startup
 			settings.Set("GamePath", argv[i]);
@@ -103,6 +103,16 @@ struct CoreSettings {
 	int GUIEnhancements = 23;
 
 	bool KeepCache = false;
+	bool PrewarmArchives = false; // decompress all compressed BIFs on a thread pool at startup
+	int ResourceCacheMB = 64; // budget for keeping released items, spells, animations etc. around; 0 means no limit
+	int AudioCacheMB = 32; // budget for decoded sounds, for effects and ambients each; 0 means no limit
+	bool KeepEncodedSounds = false; // keep often played sounds as stored when dropping their decoded samples
+	bool HierarchicalPathfinding = true; // plan long paths over map chunks first, see PathClusters
+	bool ReorderTriggers = false; // evaluate cheap script triggers first, see Condition::ReorderTriggers
+	int ScriptBudget = 0; // microseconds of script rounds per tick before less important ones get postponed; 0 means no limit
+	int BenchmarkTicks = 0; // run this many game ticks of BenchmarkSave as fast as possible, report timings and quit
+	std::string BenchmarkSave;
+	uint32_t BenchmarkSeed = 1;
 	bool MultipleQuickSaves = false;
 	bool UseAsLibrary = false;
 	// once GemRB own format is working well, this might be set to 0
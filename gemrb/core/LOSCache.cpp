@@ -0,0 +1,72 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "LOSCache.h"
+
+#include <functional>
+
+namespace GemRB {
+
+size_t LOSCache::KeyHash::operator()(const Key& key) const noexcept
+{
+	uint64_t src = (uint64_t(uint32_t(key.s.x)) << 32) | uint32_t(key.s.y);
+	uint64_t dst = (uint64_t(uint32_t(key.d.x)) << 32) | uint32_t(key.d.y);
+	std::hash<uint64_t> hasher;
+	size_t hash = hasher(src);
+	hash ^= hasher(dst) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+	hash ^= size_t(key.step) * 0x9e3779b1U;
+	return hash;
+}
+
+bool LOSCache::Lookup(const BasePoint& s, const BasePoint& d, int step, bool& visible)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	auto it = results.find(Key { s, d, step });
+	if (it == results.end()) {
+		++stats.misses;
+		return false;
+	}
+	++stats.hits;
+	visible = it->second;
+	return true;
+}
+
+void LOSCache::Store(const BasePoint& s, const BasePoint& d, int step, bool visible)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	if (results.size() >= MAX_ENTRIES) {
+		results.clear();
+	}
+	results[Key { s, d, step }] = visible;
+}
+
+void LOSCache::Clear()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	results.clear();
+}
+
+LOSCache::Stats LOSCache::GetStats() const
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return stats;
+}
+
+}
@@ -0,0 +1,81 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Memo of line of sight checks for one area
+// Sight is only blocked by walls and opaque doors, never by actors, so the
+// answers stay valid until the searchmap changes in those respects (doors
+// toggling, debug painting) and the owner clears the cache.
+// The traced line depends on the exact end points and the caller's step,
+// so they are all part of the key. Searches on worker threads may consult
+// it too, hence the locking.
+
+#ifndef LOSCACHE_H
+#define LOSCACHE_H
+
+#include "exports.h"
+
+#include "Region.h"
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace GemRB {
+
+class GEM_EXPORT LOSCache {
+public:
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+	};
+
+	// returns false if the pair wasn't checked yet
+	bool Lookup(const BasePoint& s, const BasePoint& d, int step, bool& visible);
+	void Store(const BasePoint& s, const BasePoint& d, int step, bool visible);
+	void Clear();
+	Stats GetStats() const;
+
+private:
+	struct Key {
+		BasePoint s;
+		BasePoint d;
+		int step;
+
+		bool operator==(const Key& other) const noexcept
+		{
+			return s == other.s && d == other.d && step == other.step;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& key) const noexcept;
+	};
+
+	// a full area worth of pairs is way more than what is ever looked at again
+	static constexpr size_t MAX_ENTRIES = 1 << 16;
+
+	mutable std::mutex lock;
+	std::unordered_map<Key, bool, KeyHash> results;
+	Stats stats;
+};
+
+}
+
+#endif
@@ -42,6 +42,7 @@
 #include "RNG.h"
 #include "SaveGameIterator.h"
 #include "ScriptedAnimation.h"
+#include "SubsystemTimer.h"
 #include "TileMap.h"
 #include "VEFObject.h"
 
@@ -440,6 +441,9 @@ Map::Map(TileMap* tm, TileProps props, Holder<Sprite2D> sm)
 {
 	area = this;
 	MasterArea = core->GetGame()->MasterArea(scriptName);
+	if (core->config.HierarchicalPathfinding) {
+		pathClusters = std::make_unique<PathClusters>(tileProps);
+	}
 }
 
 Map::~Map(void)
@@ -488,6 +492,11 @@ Map::~Map(void)
 void Map::SetTileMapProps(TileProps props)
 {
 	tileProps = std::move(props);
+	if (pathClusters) {
+		pathClusters = std::make_unique<PathClusters>(tileProps);
+	}
+	navmapLOS.Clear();
+	searchmapLOS.Clear();
 }
 
 const MapReverbProperties& Map::GetReverbProperties() const
@@ -722,6 +731,8 @@ void Map::UpdateScripts()
 	ieDword time = game->Ticks; // make sure everything moves at the same time
 
 	//Run actor scripts (only for 0 priority)
+	ScriptScheduler& scheduler = game->scriptScheduler;
+	scheduler.Collect(true);
 	const auto& runQueue = queue[int(Priority::RunScripts)];
 	size_t q = runQueue.size();
 	while (q--) {
@@ -780,9 +791,10 @@ void Map::UpdateScripts()
 			// do it more often out of combat, so they're less likely to get stuck
 			unsigned int radius = actor->GetAnims()->GetCircleSize();
 			if (!actor->ValidTarget(GA_CAN_BUMP)) radius = actor->CircleSize2Radius() * 4;
+			// it keeps following its current path until the new one is ready
 			const Actor* nearActor = GetActorInRadius(actor->Pos, GA_NO_DEAD | GA_NO_UNSCHEDULED | GA_NO_SELF, radius, actor);
 			if (nearActor) {
-				actor->NewPath();
+				pathQueue.Submit(actor);
 			}
 			Point lastPos = actor->Pos;
 			DoStepForActor(actor, time);
@@ -801,6 +813,16 @@ void Map::UpdateScripts()
 			DoStepForActor(actor, time);
 		}
 	}
+	scheduler.Collect(false);
+
+	// the rounds held back for the more important ones, their actions start next tick
+	for (const ScriptScheduler::Round& round : scheduler.TakeHeld()) {
+		Actor* actor = GetActorByGlobalID(round.id);
+		if (actor && actor->GetCurrentArea() == this) {
+			actor->StartScriptRound(round.priority);
+		}
+	}
+	pathQueue.Solve(*this);
 
 	//clean up effects on dead actors too
 	const auto& displayQueue = queue[int(Priority::Display)];
@@ -950,6 +972,65 @@ void Map::ClearSearchMapFor(const Movable* actor) const
 	}
 }
 
+// the footprint lifted for the searches on this thread, see PathQueue
+static thread_local const Map::Footprint* liftedFootprint = nullptr;
+
+Map::Footprint Map::LiftedFootprint(const Movable* actor) const
+{
+	// also covers the neighbours restored inside the actor's circle
+	constexpr int reach = MAX_CIRCLESIZE;
+	Footprint footprint;
+	footprint.tiles = Region(actor->SMPos.x - reach, actor->SMPos.y - reach, 2 * reach + 1, 2 * reach + 1);
+
+	std::vector<PathMapFlags> before;
+	before.reserve(footprint.tiles.size.Area());
+	for (int y = footprint.tiles.y; y <= footprint.tiles.y + 2 * reach; ++y) {
+		for (int x = footprint.tiles.x; x <= footprint.tiles.x + 2 * reach; ++x) {
+			before.push_back(tileProps.QuerySearchMap(SearchmapPoint(x, y)));
+		}
+	}
+
+	// let the real thing do the work, then put everything back
+	ClearSearchMapFor(actor);
+	footprint.flags.reserve(before.size());
+	auto flag = before.cbegin();
+	for (int y = footprint.tiles.y; y <= footprint.tiles.y + 2 * reach; ++y) {
+		for (int x = footprint.tiles.x; x <= footprint.tiles.x + 2 * reach; ++x) {
+			SearchmapPoint p(x, y);
+			footprint.flags.push_back(tileProps.QuerySearchMap(p));
+			tileProps.PaintSearchMap(p, *flag++);
+		}
+	}
+	return footprint;
+}
+
+Map::FootprintView::FootprintView(const Footprint& footprint) noexcept
+	: previous(liftedFootprint)
+{
+	liftedFootprint = &footprint;
+}
+
+Map::FootprintView::~FootprintView() noexcept
+{
+	liftedFootprint = previous;
+}
+
+void Map::InvalidateSearchMap(const Region& tiles) const
+{
+	if (pathClusters) {
+		pathClusters->Invalidate(tiles);
+	}
+	navmapLOS.Clear();
+	searchmapLOS.Clear();
+}
+
+void Map::UpdateActorGrid(const Actor* actor)
+{
+	// covers both the personal distance and the ground circle (IsOver)
+	actorReach = std::max(actorReach, actor->CircleSize2Radius() * 4);
+	actorGrid.Move(actor, actor->Pos);
+}
+
 Size Map::FogMapSize() const
 {
 	// Ratio of bg tile size and fog tile size
@@ -1810,6 +1891,7 @@ void Map::AddAnimation(AreaAnimation anim)
 //this might be unnecessary later
 void Map::UpdateEffects()
 {
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Effects);
 	size_t i = actors.size();
 	while (i--) {
 		actors[i]->RefreshEffects();
@@ -1818,6 +1900,7 @@ void Map::UpdateEffects()
 
 void Map::UpdateProjectiles()
 {
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Projectiles);
 	for (auto it = projectiles.begin(); it != projectiles.end();) {
 		(*it)->Update();
 		if ((*it)->IsStillIntact()) {
@@ -1870,7 +1953,7 @@ int Map::CountSummons(ieDword flags, ieDword sex) const
 bool Map::AnyEnemyNearPoint(const Point& p) const
 {
 	ieDword gametime = core->GetGame()->GameTime;
-	for (const Actor* actor : actors) {
+	for (const Actor* actor : GetActorsNear(p, SPAWN_RANGE)) {
 		if (!actor->Schedule(gametime, true)) {
 			continue;
 		}
@@ -1939,6 +2022,23 @@ void Map::InitActors()
 	}
 }
 
+// get the likely first combat sounds decoded in the background
+// area ambients don't need this, their thread decodes them itself
+void Map::PrefetchSounds() const
+{
+	std::vector<ResRef> sounds;
+	for (const Actor* actor : actors) {
+		actor->GetCombatSounds(sounds);
+		if (sounds.size() >= AudioPlayback::MAX_PREFETCH) break;
+	}
+
+	AudioPlaybackConfig config = core->GetAudioSettings().ConfigPresetByChannel(SFXChannel::Monster, Point());
+	size_t count = std::min(sounds.size(), AudioPlayback::MAX_PREFETCH);
+	for (size_t i = 0; i < count; ++i) {
+		core->GetAudioPlayback().Prefetch(sounds[i], config);
+	}
+}
+
 void Map::MarkVisited(const Actor* actor) const
 {
 	if (actor->InParty && core->HasFeature(GFFlags::AREA_VISITED_VAR)) {
@@ -1956,7 +2056,10 @@ void Map::AddActor(Actor* actor, bool init)
 	actor->AreaName = scriptName;
 	if (!HasActor(actor)) {
 		actors.push_back(actor);
+		actorGrid.Insert(actor, actor->Pos);
+		actorStats.Invalidate();
 	}
+	UpdateActorGrid(actor);
 	if (init) {
 		actor->SetMap(this);
 		MarkVisited(actor);
@@ -2002,7 +2105,9 @@ void Map::DeleteActor(size_t idx)
 		}
 	}
 	//remove the actor from the area's actor list
+	actorGrid.Remove(actors[idx]);
 	actors.erase(actors.begin() + idx);
+	actorStats.Invalidate();
 }
 
 Scriptable* Map::GetScriptableByGlobalID(ieDword objectID)
@@ -2067,6 +2172,30 @@ InfoPoint* Map::GetInfoPointByGlobalID(ieDword objectID) const
 	return nullptr;
 }
 
+std::vector<Actor*> Map::GetActorsNear(const Point& p, unsigned int range) const
+{
+	// no point in bucketing anything for map-wide queries
+	if (range > INT16_MAX) {
+		return actors;
+	}
+	int r = int(range);
+	return GetActorsNear(Region(p.x - r, p.y - r, 2 * r + 1, 2 * r + 1));
+}
+
+std::vector<Actor*> Map::GetActorsNear(Region rgn) const
+{
+	if (rgn.w < 0) {
+		rgn.x += rgn.w;
+		rgn.w = -rgn.w;
+	}
+	if (rgn.h < 0) {
+		rgn.y += rgn.h;
+		rgn.h = -rgn.h;
+	}
+	rgn.ExpandAllSides(actorReach);
+	return actorGrid.Query(rgn);
+}
+
 Actor* Map::GetActorByGlobalID(ieDword objectID) const
 {
 	if (!objectID) {
@@ -2132,7 +2261,7 @@ std::vector<Scriptable*> Map::GetScriptablesInRect(const Point& p, unsigned int
 
 Actor* Map::GetActor(const Point& p, int flags, const Movable* checker) const
 {
-	for (auto actor : actors) {
+	for (auto actor : GetActorsNear(p, 0)) {
 		if (!actor->IsOver(p))
 			continue;
 		if (!actor->ValidTarget(flags, checker)) {
@@ -2145,7 +2274,7 @@ Actor* Map::GetActor(const Point& p, int flags, const Movable* checker) const
 
 Actor* Map::GetActorInRadius(const Point& p, int flags, unsigned int radius, const Scriptable* checker) const
 {
-	for (auto actor : actors) {
+	for (auto actor : GetActorsNear(p, radius)) {
 		if (PersonalDistance(p, actor) > radius)
 			continue;
 		if (!actor->ValidTarget(flags, checker)) {
@@ -2159,7 +2288,8 @@ Actor* Map::GetActorInRadius(const Point& p, int flags, unsigned int radius, con
 std::vector<Actor*> Map::GetAllActorsInRadius(const Point& p, int flags, unsigned int radius, const Scriptable* see) const
 {
 	std::vector<Actor*> neighbours;
-	for (auto actor : actors) {
+	// a foot is at most 16 pixels
+	for (auto actor : GetActorsNear(p, radius * 16)) {
 		if (!WithinRange(actor, p, radius)) {
 			continue;
 		}
@@ -2288,6 +2418,11 @@ void Map::PurgeArea(bool items)
 	}
 }
 
+bool Map::GetActorsByStat(unsigned int stat, const ActorStatIndex::Filter& accept, std::vector<Actor*>& found) const
+{
+	return actorStats.Find(actors, stat, accept, found);
+}
+
 Actor* Map::GetActor(int index, bool any) const
 {
 	if (any) {
@@ -2400,8 +2535,7 @@ Actor* Map::GetActorByScriptName(const ieVariable& name) const
 std::vector<Actor*> Map::GetActorsInRect(const Region& rgn, int excludeFlags) const
 {
 	std::vector<Actor*> actorlist;
-	actorlist.reserve(actors.size());
-	for (auto actor : actors) {
+	for (auto actor : GetActorsNear(rgn)) {
 		if (!actor->ValidTarget(excludeFlags))
 			continue;
 		if (!rgn.PointInside(actor->Pos) && !actor->IsOver(rgn.origin)) // imagine drawing a tiny box inside the circle, but not over the center
@@ -2525,7 +2659,13 @@ PathMapFlags Map::GetBlockedTile(const SearchmapPoint& p, int size) const
 // p is in tile coords
 PathMapFlags Map::GetBlockedTile(const SearchmapPoint& p) const
 {
-	PathMapFlags ret = tileProps.QuerySearchMap(p);
+	PathMapFlags ret;
+	if (liftedFootprint && liftedFootprint->tiles.PointInside(Point(p.x, p.y))) {
+		const Region& tiles = liftedFootprint->tiles;
+		ret = liftedFootprint->flags[(p.y - tiles.y) * tiles.w + p.x - tiles.x];
+	} else {
+		ret = tileProps.QuerySearchMap(p);
+	}
 	if (bool(ret & PathMapFlags::TRAVEL)) {
 		ret |= PathMapFlags::PASSABLE;
 	}
@@ -2660,16 +2800,33 @@ PathMapFlags Map::GetBlockedInLineTile(const SearchmapPoint& s, const SearchmapP
 }
 
 // PathMapFlags::SIDEWALL obstructs LOS, while PathMapFlags::IMPASSABLE doesn't
+// the caller only matters for the step size, actors never block sight
 bool Map::IsVisibleLOS(const Point& s, const Point& d, const Actor* caller) const
 {
+	int step = caller ? caller->GetSpeed() : 0;
+	bool visible = false;
+	if (navmapLOS.Lookup(s, d, step, visible)) {
+		return visible;
+	}
+
 	PathMapFlags ret = GetBlockedInLine(s, d, false, caller);
-	return !bool(ret & PathMapFlags::SIDEWALL);
+	visible = !bool(ret & PathMapFlags::SIDEWALL);
+	navmapLOS.Store(s, d, step, visible);
+	return visible;
 }
 
 bool Map::IsVisibleLOS(const SearchmapPoint& s, const SearchmapPoint& d, const Actor* caller) const
 {
+	int step = caller ? caller->GetSpeed() : 0;
+	bool visible = false;
+	if (searchmapLOS.Lookup(s, d, step, visible)) {
+		return visible;
+	}
+
 	PathMapFlags ret = GetBlockedInLineTile(s, d, false, caller);
-	return !bool(ret & PathMapFlags::SIDEWALL);
+	visible = !bool(ret & PathMapFlags::SIDEWALL);
+	searchmapLOS.Store(s, d, step, visible);
+	return visible;
 }
 
 // Used by the pathfinder, so PathMapFlags::IMPASSABLE obstructs walkability
@@ -2949,7 +3106,9 @@ void Map::RemoveActor(Actor* actor)
 			ClearSearchMapFor(actor);
 			actor->SetMap(nullptr);
 			actor->AreaName.Reset();
+			actorGrid.Remove(actor);
 			actors.erase(actors.begin() + i);
+			actorStats.Invalidate();
 			return;
 		}
 	}
@@ -3010,6 +3169,14 @@ std::string Map::dump(bool show_actors) const
 	AppendFormat(buffer, "Weather: {}\n", YesNo(AreaType & AT_WEATHER));
 	AppendFormat(buffer, "Area Type: {}\n", AreaType & (AT_CITY | AT_FOREST | AT_DUNGEON));
 	AppendFormat(buffer, "Can rest: {}\n", YesNo(core->GetGame()->CanPartyRest(RestChecks::Area)));
+	LOSCache::Stats navStats = navmapLOS.GetStats();
+	LOSCache::Stats tileStats = searchmapLOS.GetStats();
+	uint64_t losHits = navStats.hits + tileStats.hits;
+	uint64_t losChecks = losHits + navStats.misses + tileStats.misses;
+	AppendFormat(buffer, "LOS cache: {} hits out of {} checks ({}%)\n", losHits, losChecks, losChecks ? losHits * 100 / losChecks : 0);
+	const Actor::EffectCacheStats& fxStats = Actor::GetEffectCacheStats();
+	uint64_t replays = fxStats.hits + fxStats.misses + fxStats.uncacheable;
+	AppendFormat(buffer, "Effect cache: {} hits out of {} replays ({}%), {} uncacheable\n", fxStats.hits, replays, replays ? fxStats.hits * 100 / replays : 0, fxStats.uncacheable);
 
 	if (show_actors) {
 		buffer.append("\n");
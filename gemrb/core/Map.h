@@ -23,11 +23,16 @@
 
 #include "exports.h"
 
+#include "ActorStatIndex.h"
 #include "Bitmap.h"
 #include "FogRenderer.h"
+#include "LOSCache.h"
 #include "MapReverb.h"
+#include "PathClusters.h"
 #include "PathFinder.h"
+#include "PathQueue.h"
 #include "Polygon.h"
+#include "SpatialGrid.h"
 #include "TableMgr.h"
 #include "WorldMap.h"
 
@@ -416,6 +421,20 @@ private:
 	VideoBufferPtr wallStencil = nullptr;
 	Region stencilViewport;
 
+	// coarse searchmap graph for long paths, refreshed lazily by FindPath
+	std::unique_ptr<PathClusters> pathClusters;
+	// IsVisibleLOS results, per coordinate space
+	mutable LOSCache navmapLOS;
+	mutable LOSCache searchmapLOS;
+	// repathing of walking actors, solved at the end of UpdateScripts
+	PathQueue pathQueue;
+	// actors bucketed by position for the proximity lookups
+	SpatialGrid<Actor> actorGrid { Size(128, 96) };
+	// largest ground circle reach seen, queries are padded by it
+	int actorReach = 16;
+	// actors bucketed by the stats object selectors match on
+	mutable ActorStatIndex actorStats;
+
 	std::unordered_map<const void*, std::pair<VideoBufferPtr, Region>> objectStencils;
 
 	class MapReverb {
@@ -509,6 +528,7 @@ public:
 	void ActorSpottedByPlayer(const Actor* actor) const;
 	bool HandleAutopauseForVisible(Actor* actor, bool) const;
 	void InitActors();
+	void PrefetchSounds() const;
 	void MarkVisited(const Actor* actor) const;
 	void AddActor(Actor* actor, bool init);
 	//counts the summons already in the area
@@ -549,6 +569,10 @@ public:
 	Actor* GetRandomEnemySeen(const Actor* origin) const;
 
 	int GetActorCount(bool any) const;
+	// the actors whose stat passes accept, in GetActor order; false if the stat isn't indexed
+	bool GetActorsByStat(unsigned int stat, const ActorStatIndex::Filter& accept, std::vector<Actor*>& found) const;
+	// call when an actor of the area changed one of the ActorStatIndex stats
+	void InvalidateActorStats() const { actorStats.Invalidate(); }
 	//fix actors position if required
 	void JumpActors(bool jump) const;
 	//selects all selectable actors in the area
@@ -606,6 +630,27 @@ public:
 	void ExploreMapChunk(const SearchmapPoint& pos, int range, int los);
 	void BlockSearchMapFor(const Movable* actor) const;
 	void ClearSearchMapFor(const Movable* actor) const;
+	/* the searchmap around an actor as ClearSearchMapFor leaves it, without changing it */
+	struct Footprint {
+		Region tiles;
+		std::vector<PathMapFlags> flags;
+	};
+	Footprint LiftedFootprint(const Movable* actor) const;
+	/* while alive, searchmap queries on this thread see the footprint lifted */
+	class GEM_EXPORT FootprintView {
+	public:
+		explicit FootprintView(const Footprint& footprint) noexcept;
+		~FootprintView() noexcept;
+		FootprintView(const FootprintView&) = delete;
+		FootprintView& operator=(const FootprintView&) = delete;
+
+	private:
+		const Footprint* previous;
+	};
+	/* the walls or doors on these searchmap tiles changed */
+	void InvalidateSearchMap(const Region& tiles) const;
+	/* the actor moved or changed size, refresh its spot in the actor grid */
+	void UpdateActorGrid(const Actor* actor);
 	/* update VisibleBitmap by resolving vision of all explore actors */
 	void UpdateFog();
 	//PathFinder
@@ -687,6 +732,9 @@ private:
 	Particles* GetNextSpark(const spaIterator& iter) const;
 	VEFObject* GetNextScriptedAnimation(const scaIterator& iter) const;
 	Actor* GetNextActor(int& q, size_t& index) const;
+	// candidates for the proximity lookups, in actors order
+	std::vector<Actor*> GetActorsNear(const Point& p, unsigned int range) const;
+	std::vector<Actor*> GetActorsNear(Region rgn) const;
 	Container* GetNextPile(size_t& index) const;
 
 	void RedrawScreenStencil(const Region& vp, const WallPolygonGroup& walls);
@@ -0,0 +1,358 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "PathClusters.h"
+
+#include "Map.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace GemRB {
+
+// walking costs between searchmap tiles, roughly 1:sqrt(2)
+constexpr uint16_t STRAIGHT_COST = 5;
+constexpr uint16_t DIAGONAL_COST = 7;
+constexpr uint16_t UNREACHABLE = std::numeric_limits<uint16_t>::max();
+constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+// octile distance, never more than the real walking cost
+static uint32_t EstimateCost(const SearchmapPoint& a, const SearchmapPoint& b)
+{
+	uint32_t dx = std::abs(a.x - b.x);
+	uint32_t dy = std::abs(a.y - b.y);
+	return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+}
+
+PathClusters::PathClusters(const TileProps& props)
+	: props(props)
+{
+	const Size& mapSize = props.GetSize();
+	clustersSize = Size(CeilDiv(mapSize.w, CLUSTER_SIZE), CeilDiv(mapSize.h, CLUSTER_SIZE));
+	clusters.resize(clustersSize.Area());
+	for (int cy = 0; cy < clustersSize.h; ++cy) {
+		for (int cx = 0; cx < clustersSize.w; ++cx) {
+			int x = cx * CLUSTER_SIZE;
+			int y = cy * CLUSTER_SIZE;
+			clusters[cy * clustersSize.w + cx].bounds = Region(x, y, std::min(int(CLUSTER_SIZE), mapSize.w - x), std::min(int(CLUSTER_SIZE), mapSize.h - y));
+		}
+	}
+	bfsDistances.resize(CLUSTER_SIZE * CLUSTER_SIZE);
+	Update();
+}
+
+// like Map::GetBlockedTile, but ignoring actors
+bool PathClusters::Walkable(const SearchmapPoint& p) const
+{
+	PathMapFlags flags = props.QuerySearchMap(p);
+	if (bool(flags & PathMapFlags::DOOR)) {
+		return false;
+	}
+	return bool(flags & (PathMapFlags::PASSABLE | PathMapFlags::TRAVEL));
+}
+
+int PathClusters::ClusterAt(const SearchmapPoint& p) const
+{
+	return (p.y / CLUSTER_SIZE) * clustersSize.w + p.x / CLUSTER_SIZE;
+}
+
+int PathClusters::Neighbour(int cluster, Side side) const
+{
+	int cx = cluster % clustersSize.w;
+	int cy = cluster / clustersSize.w;
+	switch (side) {
+		case EAST:
+			return cx + 1 < clustersSize.w ? cluster + 1 : -1;
+		case SOUTH:
+			return cy + 1 < clustersSize.h ? cluster + clustersSize.w : -1;
+		case WEST:
+			return cx > 0 ? cluster - 1 : -1;
+		case NORTH:
+			return cy > 0 ? cluster - clustersSize.w : -1;
+	}
+	return -1;
+}
+
+// only called for EAST and SOUTH, the neighbour gets the mirrored portals,
+// so the nth portal on both sides of a border is the same crossing
+void PathClusters::FindPortals(int cluster, Side side)
+{
+	Cluster& ours = clusters[cluster];
+	ours.portals[side].clear();
+	int neighbour = Neighbour(cluster, side);
+	if (neighbour == -1) {
+		return;
+	}
+	Side opposite = Side((side + 2) % 4);
+	Cluster& theirs = clusters[neighbour];
+	theirs.portals[opposite].clear();
+
+	const Region& bounds = ours.bounds;
+	SearchmapPoint first;
+	SearchmapPoint step;
+	SearchmapPoint across;
+	int length;
+	if (side == EAST) {
+		first = SearchmapPoint(bounds.x + bounds.w - 1, bounds.y);
+		step = SearchmapPoint(0, 1);
+		across = SearchmapPoint(1, 0);
+		length = bounds.h;
+	} else {
+		first = SearchmapPoint(bounds.x, bounds.y + bounds.h - 1);
+		step = SearchmapPoint(1, 0);
+		across = SearchmapPoint(0, 1);
+		length = bounds.w;
+	}
+
+	// one portal in the middle of each run of tiles passable on both sides
+	int runStart = -1;
+	for (int i = 0; i <= length; ++i) {
+		SearchmapPoint p = first + step * i;
+		bool open = i < length && Walkable(p) && Walkable(p + across);
+		if (open && runStart == -1) {
+			runStart = i;
+		} else if (!open && runStart != -1) {
+			SearchmapPoint middle = first + step * ((runStart + i - 1) / 2);
+			ours.portals[side].emplace_back(middle, middle + across);
+			theirs.portals[opposite].emplace_back(middle + across, middle);
+			runStart = -1;
+		}
+	}
+}
+
+// Dijkstra over the walkable tiles of the cluster, not leaving it
+void PathClusters::FloodFill(const Cluster& cluster, const SearchmapPoint& from)
+{
+	const Region& bounds = cluster.bounds;
+	std::array<bool, CLUSTER_SIZE * CLUSTER_SIZE> walkable {};
+	for (int y = 0; y < bounds.h; ++y) {
+		for (int x = 0; x < bounds.w; ++x) {
+			walkable[y * CLUSTER_SIZE + x] = Walkable(SearchmapPoint(bounds.x + x, bounds.y + y));
+		}
+	}
+	std::fill(bfsDistances.begin(), bfsDistances.end(), UNREACHABLE);
+
+	using Entry = std::pair<uint16_t, int>; // distance, tile index in the cluster
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+	int start = (from.y - bounds.y) * CLUSTER_SIZE + from.x - bounds.x;
+	bfsDistances[start] = 0;
+	open.emplace(0, start);
+	while (!open.empty()) {
+		Entry current = open.top();
+		open.pop();
+		if (current.first > bfsDistances[current.second]) continue;
+
+		int x = current.second % CLUSTER_SIZE;
+		int y = current.second / CLUSTER_SIZE;
+		for (int dy = -1; dy <= 1; ++dy) {
+			for (int dx = -1; dx <= 1; ++dx) {
+				int nx = x + dx;
+				int ny = y + dy;
+				if ((!dx && !dy) || nx < 0 || ny < 0 || nx >= bounds.w || ny >= bounds.h) continue;
+				if (!walkable[ny * CLUSTER_SIZE + nx]) continue;
+				// no cutting corners, the pathfinder only expands in 4 directions
+				bool diagonal = dx && dy;
+				if (diagonal && !(walkable[y * CLUSTER_SIZE + nx] && walkable[ny * CLUSTER_SIZE + x])) continue;
+
+				uint16_t distance = current.first + (diagonal ? DIAGONAL_COST : STRAIGHT_COST);
+				int idx = ny * CLUSTER_SIZE + nx;
+				if (distance < bfsDistances[idx]) {
+					bfsDistances[idx] = distance;
+					open.emplace(distance, idx);
+				}
+			}
+		}
+	}
+}
+
+uint16_t PathClusters::FilledDistance(const Cluster& cluster, const SearchmapPoint& to) const
+{
+	return bfsDistances[(to.y - cluster.bounds.y) * CLUSTER_SIZE + to.x - cluster.bounds.x];
+}
+
+void PathClusters::Rebuild(int idx)
+{
+	Cluster& cluster = clusters[idx];
+	cluster.nodes.clear();
+	for (uint8_t side = EAST; side <= NORTH; ++side) {
+		cluster.sideOffset[side] = uint16_t(cluster.nodes.size());
+		for (const Portal& portal : cluster.portals[side]) {
+			cluster.nodes.push_back(portal.first);
+		}
+	}
+
+	size_t count = cluster.nodes.size();
+	cluster.distances.assign(count * count, UNREACHABLE);
+	for (size_t i = 0; i < count; ++i) {
+		FloodFill(cluster, cluster.nodes[i]);
+		for (size_t j = i; j < count; ++j) {
+			uint16_t distance = FilledDistance(cluster, cluster.nodes[j]);
+			cluster.distances[i * count + j] = distance;
+			cluster.distances[j * count + i] = distance;
+		}
+	}
+}
+
+void PathClusters::Update()
+{
+	std::vector<int> stale;
+	for (int idx = 0; idx < int(clusters.size()); ++idx) {
+		if (clusters[idx].dirty) stale.push_back(idx);
+	}
+	if (stale.empty()) return;
+
+	// portals are shared with the neighbours, so their distances need redoing too
+	std::vector<bool> rebuild(clusters.size(), false);
+	for (int idx : stale) {
+		FindPortals(idx, EAST);
+		FindPortals(idx, SOUTH);
+		int west = Neighbour(idx, WEST);
+		if (west != -1) FindPortals(west, EAST);
+		int north = Neighbour(idx, NORTH);
+		if (north != -1) FindPortals(north, SOUTH);
+
+		rebuild[idx] = true;
+		for (uint8_t side = EAST; side <= NORTH; ++side) {
+			int neighbour = Neighbour(idx, Side(side));
+			if (neighbour != -1) rebuild[neighbour] = true;
+		}
+	}
+
+	nodeCount = 0;
+	nodeClusters.clear();
+	for (int idx = 0; idx < int(clusters.size()); ++idx) {
+		Cluster& cluster = clusters[idx];
+		if (rebuild[idx]) Rebuild(idx);
+		cluster.dirty = false;
+		cluster.firstNode = nodeCount;
+		nodeCount += uint32_t(cluster.nodes.size());
+		nodeClusters.insert(nodeClusters.end(), cluster.nodes.size(), idx);
+	}
+}
+
+void PathClusters::Invalidate(const Region& tiles)
+{
+	std::lock_guard<std::mutex> l(lock);
+	int minX = std::max(tiles.x, 0) / CLUSTER_SIZE;
+	int minY = std::max(tiles.y, 0) / CLUSTER_SIZE;
+	int maxX = std::min((tiles.x + tiles.w - 1) / CLUSTER_SIZE, clustersSize.w - 1);
+	int maxY = std::min((tiles.y + tiles.h - 1) / CLUSTER_SIZE, clustersSize.h - 1);
+	for (int cy = minY; cy <= maxY; ++cy) {
+		for (int cx = minX; cx <= maxX; ++cx) {
+			clusters[cy * clustersSize.w + cx].dirty = true;
+		}
+	}
+}
+
+// A* over the portal graph, with s and d as extra nodes tied to the portals of their clusters
+bool PathClusters::FindWaypoints(const SearchmapPoint& s, const SearchmapPoint& d, std::vector<SearchmapPoint>& waypoints)
+{
+	waypoints.clear();
+	const Size& mapSize = props.GetSize();
+	if (!mapSize.PointInside(s) || !mapSize.PointInside(d)) return true;
+	int sourceCluster = ClusterAt(s);
+	int destCluster = ClusterAt(d);
+	if (sourceCluster == destCluster) return true;
+
+	std::lock_guard<std::mutex> l(lock);
+	Update();
+	const Cluster& source = clusters[sourceCluster];
+	const Cluster& dest = clusters[destCluster];
+	const uint32_t sourceNode = nodeCount;
+	const uint32_t destNode = nodeCount + 1;
+
+	FloodFill(dest, d);
+	std::vector<uint16_t> destDistances(dest.nodes.size());
+	for (size_t i = 0; i < dest.nodes.size(); ++i) {
+		destDistances[i] = FilledDistance(dest, dest.nodes[i]);
+	}
+	FloodFill(source, s);
+
+	auto nodePoint = [&](uint32_t node) {
+		if (node == sourceNode) return s;
+		if (node == destNode) return d;
+		const Cluster& cluster = clusters[nodeClusters[node]];
+		return cluster.nodes[node - cluster.firstNode];
+	};
+
+	std::vector<uint32_t> costs(nodeCount + 2, std::numeric_limits<uint32_t>::max());
+	std::vector<uint32_t> parents(nodeCount + 2, NO_NODE);
+	using Entry = std::pair<uint32_t, uint32_t>; // estimated total cost, node
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<>> open;
+	auto relax = [&](uint32_t from, uint32_t to, uint32_t cost) {
+		if (cost >= costs[to]) return;
+		costs[to] = cost;
+		parents[to] = from;
+		open.emplace(cost + EstimateCost(nodePoint(to), d), to);
+	};
+
+	costs[sourceNode] = 0;
+	for (size_t i = 0; i < source.nodes.size(); ++i) {
+		uint16_t distance = FilledDistance(source, source.nodes[i]);
+		if (distance != UNREACHABLE) relax(sourceNode, source.firstNode + uint32_t(i), distance);
+	}
+
+	while (!open.empty()) {
+		Entry current = open.top();
+		open.pop();
+		uint32_t node = current.second;
+		if (node == destNode) break;
+		if (current.first > costs[node] + EstimateCost(nodePoint(node), d)) continue;
+
+		int clusterIdx = nodeClusters[node];
+		const Cluster& cluster = clusters[clusterIdx];
+		uint32_t local = node - cluster.firstNode;
+		size_t count = cluster.nodes.size();
+		for (size_t j = 0; j < count; ++j) {
+			uint16_t distance = cluster.distances[local * count + j];
+			if (j != local && distance != UNREACHABLE) {
+				relax(node, cluster.firstNode + uint32_t(j), costs[node] + distance);
+			}
+		}
+		if (clusterIdx == destCluster && destDistances[local] != UNREACHABLE) {
+			relax(node, destNode, costs[node] + destDistances[local]);
+		}
+
+		// step over to the matching portal of the neighbour
+		uint8_t side = NORTH;
+		while (local < cluster.sideOffset[side]) {
+			--side;
+		}
+		const Cluster& neighbour = clusters[Neighbour(clusterIdx, Side(side))];
+		uint32_t across = neighbour.firstNode + neighbour.sideOffset[(side + 2) % 4] + (local - cluster.sideOffset[side]);
+		relax(node, across, costs[node] + STRAIGHT_COST);
+	}
+
+	if (parents[destNode] == NO_NODE) return false;
+
+	// only keep the tiles where we enter a new cluster
+	for (uint32_t node = parents[destNode]; node != sourceNode; node = parents[node]) {
+		uint32_t parent = parents[node];
+		if (parent != sourceNode && nodeClusters[parent] != nodeClusters[node]) {
+			waypoints.push_back(nodePoint(node));
+		}
+	}
+	std::reverse(waypoints.begin(), waypoints.end());
+	return true;
+}
+
+}
@@ -0,0 +1,98 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Abstract graph for hierarchical pathfinding (HPA*, see Botea et al., 2004)
+// The searchmap is split into square clusters. Wherever two neighbouring
+// clusters share a run of walkable border tiles, a pair of portal nodes
+// is placed, and the walking distances between all portals of a cluster
+// are precomputed. Long searches then run over this small graph first and
+// only the resulting waypoints are refined on the searchmap itself.
+// Only static obstacles (walls, closed doors) are considered; actors are
+// left for the refinement to deal with.
+
+#ifndef PATHCLUSTERS_H
+#define PATHCLUSTERS_H
+
+#include "exports.h"
+
+#include "Region.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace GemRB {
+
+class TileProps;
+
+class GEM_EXPORT PathClusters {
+public:
+	static constexpr int CLUSTER_SIZE = 16; // in searchmap tiles
+
+	explicit PathClusters(const TileProps& props);
+
+	/* fills waypoints with the cluster entrances (searchmap tiles) to visit on the
+	 * way from s to d, empty if both are in the same cluster;
+	 * returns false if d can't be reached from s at all */
+	bool FindWaypoints(const SearchmapPoint& s, const SearchmapPoint& d, std::vector<SearchmapPoint>& waypoints);
+	/* the static passability of these tiles changed, e.g. due to a door */
+	void Invalidate(const Region& tiles);
+
+private:
+	enum Side : uint8_t { EAST,
+			      SOUTH,
+			      WEST,
+			      NORTH };
+	using Portal = std::pair<SearchmapPoint, SearchmapPoint>; // our side, their side
+
+	struct Cluster {
+		Region bounds;
+		// portals towards the neighbour on each side
+		std::array<std::vector<Portal>, 4> portals;
+		// all our portal tiles, in side order, and their walking distances
+		std::vector<SearchmapPoint> nodes;
+		std::array<uint16_t, 4> sideOffset {};
+		std::vector<uint16_t> distances; // nodes.size() squared
+		uint32_t firstNode = 0; // index in the whole graph
+		bool dirty = true;
+	};
+
+	const TileProps& props;
+	Size clustersSize;
+	std::vector<Cluster> clusters;
+	uint32_t nodeCount = 0;
+	std::vector<uint32_t> nodeClusters; // owner of each node
+	std::vector<uint16_t> bfsDistances; // scratch for FloodFill
+	std::mutex lock; // FindPath may run on PathQueue workers
+
+	bool Walkable(const SearchmapPoint& p) const;
+	int ClusterAt(const SearchmapPoint& p) const;
+	int Neighbour(int cluster, Side side) const;
+	void FindPortals(int cluster, Side side);
+	void FloodFill(const Cluster& cluster, const SearchmapPoint& from);
+	uint16_t FilledDistance(const Cluster& cluster, const SearchmapPoint& to) const;
+	void Rebuild(int cluster);
+	void Update();
+};
+
+}
+
+#endif
@@ -41,10 +41,12 @@
 #include "GameData.h"
 #include "Map.h"
 #include "RNG.h"
+#include "SubsystemTimer.h"
 
 #include "Logging/Logging.h"
 #include "Scriptable/Actor.h"
 
+#include <algorithm>
 #include <array>
 #include <limits>
 
@@ -61,10 +63,79 @@ constexpr std::array<float_t, RAND_DEGREES_OF_FREEDOM> dxRand { { 0.000, -0.383,
 // Sines
 constexpr std::array<float_t, RAND_DEGREES_OF_FREEDOM> dyRand { { 1.000, 0.924, 0.707, 0.383, 0.000, -0.383, -0.707, -0.924, -1.000, -0.924, -0.707, -0.383, 0.000, 0.383, 0.707, 0.924 } };
 
+// search tiles: hops up to this long are first tried in a box around both ends
+constexpr int SHORT_HOP_LENGTH = 24;
+constexpr int SHORT_HOP_MARGIN = 8;
+// longer ones are first planned over the PathClusters graph, if enabled
+constexpr int CLUSTERED_HOP_LENGTH = 3 * PathClusters::CLUSTER_SIZE;
+
+// Per-node search state for FindPath, reused across calls instead of
+// allocating and clearing map sized arrays every time. Entries are only
+// valid if stamped with the current search generation.
+class PathScratch {
+	std::vector<uint32_t> visited;
+	std::vector<uint32_t> closed;
+	std::vector<NavmapPoint> parents;
+	std::vector<unsigned short> distances;
+	uint32_t generation = 0;
+
+	void Touch(size_t idx)
+	{
+		if (visited[idx] != generation) {
+			visited[idx] = generation;
+			parents[idx] = Point(0, 0);
+			distances[idx] = std::numeric_limits<unsigned short>::max();
+		}
+	}
+
+public:
+	void Reset(size_t area)
+	{
+		if (visited.size() < area) {
+			visited.resize(area, 0);
+			closed.resize(area, 0);
+			parents.resize(area);
+			distances.resize(area);
+		}
+		if (++generation == 0) {
+			std::fill(visited.begin(), visited.end(), 0);
+			std::fill(closed.begin(), closed.end(), 0);
+			generation = 1;
+		}
+	}
+
+	bool IsClosed(size_t idx) const { return closed[idx] == generation; }
+	void Close(size_t idx) { closed[idx] = generation; }
+
+	NavmapPoint GetParent(size_t idx) const
+	{
+		return visited[idx] == generation ? parents[idx] : Point(0, 0);
+	}
+	void SetParent(size_t idx, const NavmapPoint& parent)
+	{
+		Touch(idx);
+		parents[idx] = parent;
+	}
+
+	unsigned short GetDistance(size_t idx) const
+	{
+		return visited[idx] == generation ? distances[idx] : std::numeric_limits<unsigned short>::max();
+	}
+	void SetDistance(size_t idx, unsigned short distance)
+	{
+		Touch(idx);
+		distances[idx] = distance;
+	}
+};
+
+// one per thread, so concurrent searches (on different maps) don't clash
+static thread_local PathScratch pathScratch;
+
 // Find the best path of limited length that brings us the farthest from d
 Path Map::RunAway(const Point& s, const Point& d, int maxPathLength, bool backAway, const Actor* caller) const
 {
 	if (!caller || !caller->GetSpeed()) return {};
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Pathfinding);
 	Point p = s;
 	float_t dx = s.x - d.x;
 	float_t dy = s.y - d.y;
@@ -220,11 +291,51 @@ PathNode Map::GetLineEnd(const Point& p, int steps, orient_t orient) const
 	return lineEnd;
 }
 
+// Turn the waypoints from PathClusters into a real path, with a short search
+// per leg and a regular one from the last cluster entrance to the goal
+static Path RefineClusteredPath(const Map& map, const NavmapPoint& s, const NavmapPoint& d, const std::vector<SearchmapPoint>& waypoints,
+				unsigned int size, unsigned int minDistance, int flags, const Actor* caller)
+{
+	Path path;
+	std::vector<size_t> joints;
+	NavmapPoint legStart = s;
+	unsigned int squaredMinDist = minDistance * minDistance;
+	for (const SearchmapPoint& waypoint : waypoints) {
+		NavmapPoint target = waypoint.ToNavmapPoint() + Point(8, 6);
+		// close enough for the final leg to take over
+		if (minDistance && SquaredDistance(target, d) < squaredMinDist) break;
+
+		Path leg = map.FindPath(legStart, target, size, 0, flags & ~PF_SIGHT, caller);
+		if (!leg) return {};
+		path.AppendPath(leg);
+		joints.push_back(path.Size() - 1);
+		legStart = path.nodes.back().point;
+	}
+	Path leg = map.FindPath(legStart, d, size, minDistance, flags, caller);
+	if (!leg) return {};
+	path.AppendPath(leg);
+
+	// the legs all go through the middle of the cluster entrances, so cut
+	// those corners where the direct way is free
+	bool actorsAreBlocking = flags & PF_ACTORS_ARE_BLOCKING;
+	for (auto joint = joints.rbegin(); joint != joints.rend(); ++joint) {
+		size_t idx = *joint;
+		NavmapPoint prev = idx ? path.nodes[idx - 1].point : s;
+		NavmapPoint next = path.nodes[idx + 1].point;
+		if (!map.IsWalkableTo(prev, next, actorsAreBlocking, caller)) continue;
+
+		path.nodes.erase(path.nodes.begin() + idx);
+		path.nodes[idx].orient = GetOrient(prev, next);
+	}
+	return path;
+}
+
 // Find a path from start to goal, ending at the specified distance from the
 // target (the goal must be in sight of the end, if PF_SIGHT is specified)
 Path Map::FindPath(const Point& s, const Point& d, unsigned int size, unsigned int minDistance, int flags, const Actor* caller) const
 {
 	TRACY(ZoneScoped);
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Pathfinding);
 	if (InDebugMode(DebugMode::PATHFINDER))
 		Log(DEBUG, "FindPath", "s = {}, d = {}, caller = {}, dist = {}, size = {}",
 		    s, d,
@@ -258,17 +369,22 @@ Path Map::FindPath(const Point& s, const Point& d, unsigned int size, unsigned i
 	const Size& mapSize = PropsSize();
 	if (!mapSize.PointInside(smptSource)) return {};
 
-	// Initialize data structures
-	FibonacciHeap<PQNode> open;
-	std::vector<bool> isClosed(mapSize.Area(), false);
-	std::vector<NavmapPoint> parents(mapSize.Area(), Point(0, 0));
-	std::vector<unsigned short> distFromStart(mapSize.Area(), std::numeric_limits<unsigned short>::max());
-	distFromStart[smptSource.y * mapSize.w + smptSource.x] = 0;
-	parents[smptSource.y * mapSize.w + smptSource.x] = nmptSource;
-	open.emplace(PQNode(nmptSource, 0));
-	bool foundPath = false;
+	// Long trips first plan a coarse route over the map chunks, so only
+	// the area along it gets searched
+	int hop = std::max(std::abs(smptDest.x - smptSource.x), std::abs(smptDest.y - smptSource.y));
+	if (pathClusters && hop > CLUSTERED_HOP_LENGTH && !(flags & PF_BACKAWAY)) {
+		// on a miss the full search below has the final say, the graph only
+		// knows static obstacles and may not have caught up with them yet
+		std::vector<SearchmapPoint> waypoints;
+		if (pathClusters->FindWaypoints(smptSource, smptDest, waypoints) && !waypoints.empty()) {
+			Path clusteredPath = RefineClusteredPath(*this, nmptSource, d, waypoints, size, minDistance, flags, caller);
+			if (clusteredPath) return clusteredPath;
+		}
+	}
+
 	static bool usePlainThetaStar = gamedata->GetMiscRule("LAZY_THETA_STAR") == 0;
 	unsigned int squaredMinDist = minDistance * minDistance;
+	PathScratch& scratch = pathScratch;
 
 	// Weighted heuristic. Finds sub-optimal paths but should be quite a bit faster
 	constexpr float_t HEURISTIC_WEIGHT = 1.5;
@@ -282,122 +398,155 @@ Path Map::FindPath(const Point& s, const Point& d, unsigned int size, unsigned i
 		int crossProduct = std::abs(xDist * dyCross - yDist * dxCross) >> 3;
 		double distance = std::hypot(xDist, yDist);
 		double heuristic = HEURISTIC_WEIGHT * (distance + crossProduct);
-		double estDist = distFromStart[smptChildIdx] + heuristic;
+		double estDist = scratch.GetDistance(smptChildIdx) + heuristic;
 		return estDist;
 	};
 
-	while (!open.empty()) {
-		NavmapPoint nmptCurrent = open.top().point;
-		open.pop();
-		SearchmapPoint smptCurrent { nmptCurrent };
-		int smptCurrentIdx = smptCurrent.y * mapSize.w + smptCurrent.x;
-		if (parents[smptCurrentIdx].IsZero()) {
-			continue;
-		}
+	// runs the search, only expanding nodes inside bounds (in searchmap coordinates)
+	auto search = [&](const Region& bounds) {
+		int minX = bounds.x;
+		int minY = bounds.y;
+		int maxX = bounds.x + bounds.w;
+		int maxY = bounds.y + bounds.h;
+		auto outside = [=](const SearchmapPoint& p) {
+			return p.x < minX || p.y < minY || p.x >= maxX || p.y >= maxY;
+		};
+
+		FibonacciHeap<PQNode> open;
+		scratch.Reset(mapSize.Area());
+		scratch.SetDistance(smptSource.y * mapSize.w + smptSource.x, 0);
+		scratch.SetParent(smptSource.y * mapSize.w + smptSource.x, nmptSource);
+		open.emplace(PQNode(nmptSource, 0));
+
+		while (!open.empty()) {
+			NavmapPoint nmptCurrent = open.top().point;
+			open.pop();
+			SearchmapPoint smptCurrent { nmptCurrent };
+			int smptCurrentIdx = smptCurrent.y * mapSize.w + smptCurrent.x;
+			if (scratch.GetParent(smptCurrentIdx).IsZero()) {
+				continue;
+			}
 
-		if (smptCurrent == smptDest) {
-			nmptDest = nmptCurrent;
-			foundPath = true;
-			break;
-		} else if (minDistance &&
-			   parents[smptCurrentIdx] != nmptCurrent &&
-			   SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist &&
-			   (!(flags & PF_SIGHT) || IsVisibleLOS(smptCurrent, smptDest0, caller))) { // FIXME: should probably be smptDest
-			smptDest = smptCurrent;
-			nmptDest = nmptCurrent;
-			foundPath = true;
-			break;
-		}
-		isClosed[smptCurrentIdx] = true;
-
-		for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
-			NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
-			SearchmapPoint smptChild { nmptChild };
-			// Outside map
-			if (smptChild.x < 0 || smptChild.y < 0 || smptChild.x >= mapSize.w || smptChild.y >= mapSize.h) continue;
-			// Already visited
-			int smptChildIdx = smptChild.y * mapSize.w + smptChild.x;
-			if (isClosed[smptChildIdx]) continue;
-
-			PathMapFlags childBlockStatus;
-			if (size > 2) {
-				childBlockStatus = GetBlockedInRadiusTile(smptChild, size);
-			} else {
-				childBlockStatus = GetBlockedTile(smptChild);
+			if (smptCurrent == smptDest) {
+				nmptDest = nmptCurrent;
+				return true;
+			} else if (minDistance &&
+				   scratch.GetParent(smptCurrentIdx) != nmptCurrent &&
+				   SquaredDistance(nmptCurrent, nmptDest) < squaredMinDist &&
+				   (!(flags & PF_SIGHT) || IsVisibleLOS(smptCurrent, smptDest0, caller))) { // FIXME: should probably be smptDest
+				smptDest = smptCurrent;
+				nmptDest = nmptCurrent;
+				return true;
 			}
-			bool childBlocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR));
-			if (childBlocked) continue;
-
-			// If there's an actor, check it can be bumped away
-			const Actor* childActor = GetActor(nmptChild, GA_NO_DEAD | GA_NO_UNSCHEDULED);
-			bool childIsUnbumpable = childActor && childActor != caller && (actorsAreBlocking || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
-			if (childIsUnbumpable) continue;
-
-			SearchmapPoint smptCurrent2 { nmptCurrent };
-			NavmapPoint nmptParent = parents[smptCurrent2.y * mapSize.w + smptCurrent2.x];
-			SearchmapPoint smptParent { nmptParent };
-			unsigned short oldDist = distFromStart[smptChildIdx];
-
-			if (usePlainThetaStar) {
-				// Theta-star path if there is LOS
-				if (IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
-					unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
-					if (newDist < oldDist) {
-						parents[smptChildIdx] = nmptParent;
-						distFromStart[smptChildIdx] = newDist;
-					}
-					// Fall back to A-star path
+			scratch.Close(smptCurrentIdx);
+
+			for (size_t i = 0; i < DEGREES_OF_FREEDOM; i++) {
+				NavmapPoint nmptChild(nmptCurrent.x + 16 * dxAdjacent[i], nmptCurrent.y + 12 * dyAdjacent[i]);
+				SearchmapPoint smptChild { nmptChild };
+				// Outside map (or the searched part of it)
+				if (outside(smptChild)) continue;
+				// Already visited
+				int smptChildIdx = smptChild.y * mapSize.w + smptChild.x;
+				if (scratch.IsClosed(smptChildIdx)) continue;
+
+				PathMapFlags childBlockStatus;
+				if (size > 2) {
+					childBlockStatus = GetBlockedInRadiusTile(smptChild, size);
 				} else {
-					unsigned short newDist = distFromStart[smptCurrent2.y * mapSize.w + smptCurrent2.x] + Distance(smptCurrent2, smptChild);
-					if (newDist < oldDist) {
-						parents[smptChildIdx] = nmptCurrent;
-						distFromStart[smptChildIdx] = newDist;
-					}
+					childBlockStatus = GetBlockedTile(smptChild);
 				}
+				bool childBlocked = !(childBlockStatus & (PathMapFlags::PASSABLE | PathMapFlags::ACTOR));
+				if (childBlocked) continue;
 
-				if (distFromStart[smptChildIdx] < oldDist) {
-					PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
-					open.emplace(newNode);
-				}
-			} else {
-				// Lazy Theta star*
-				unsigned short newDist = distFromStart[smptParent.y * mapSize.w + smptParent.x] + Distance(smptParent, smptChild);
-				if (newDist < oldDist) {
-					parents[smptChildIdx] = nmptParent;
-					distFromStart[smptChildIdx] = newDist;
-				}
+				// If there's an actor, check it can be bumped away
+				const Actor* childActor = GetActor(nmptChild, GA_NO_DEAD | GA_NO_UNSCHEDULED);
+				bool childIsUnbumpable = childActor && childActor != caller && (actorsAreBlocking || !childActor->ValidTarget(GA_ONLY_BUMPABLE));
+				if (childIsUnbumpable) continue;
 
-				if (distFromStart[smptChildIdx] < oldDist) {
+				SearchmapPoint smptCurrent2 { nmptCurrent };
+				NavmapPoint nmptParent = scratch.GetParent(smptCurrent2.y * mapSize.w + smptCurrent2.x);
+				SearchmapPoint smptParent { nmptParent };
+				unsigned short oldDist = scratch.GetDistance(smptChildIdx);
+
+				if (usePlainThetaStar) {
 					// Theta-star path if there is LOS
-					// so far the searchmap grid appears too coarse to play on, see #2261
-					//if (!IsWalkableTo(smptParent, smptChild, actorsAreBlocking, caller)) {
-					if (!IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
+					if (IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
+						unsigned short newDist = scratch.GetDistance(smptParent.y * mapSize.w + smptParent.x) + Distance(smptParent, smptChild);
+						if (newDist < oldDist) {
+							scratch.SetParent(smptChildIdx, nmptParent);
+							scratch.SetDistance(smptChildIdx, newDist);
+						}
 						// Fall back to A-star path
-						distFromStart[smptChildIdx] = std::numeric_limits<unsigned short>::max();
-						// Find already visited neighbour with shortest: path from start + path to child
-						for (size_t j = 0; j < DEGREES_OF_FREEDOM; j++) {
-							NavmapPoint nmptVis(nmptChild.x + 16 * dxAdjacent[j], nmptChild.y + 12 * dyAdjacent[j]);
-							SearchmapPoint smptVis { nmptVis };
-							// Outside map
-							if (smptVis.x < 0 || smptVis.y < 0 || smptVis.x >= mapSize.w || smptVis.y >= mapSize.h) continue;
-							// Only consider already visited
-							if (!isClosed[smptVis.y * mapSize.w + smptVis.x]) continue;
-
-							unsigned short oldVisDist = distFromStart[smptChildIdx];
-							newDist = distFromStart[smptVis.y * mapSize.w + smptVis.x] + Distance(smptVis, smptChild);
-							if (newDist < oldVisDist) {
-								parents[smptChildIdx] = nmptVis;
-								distFromStart[smptChildIdx] = newDist;
-							}
+					} else {
+						unsigned short newDist = scratch.GetDistance(smptCurrent2.y * mapSize.w + smptCurrent2.x) + Distance(smptCurrent2, smptChild);
+						if (newDist < oldDist) {
+							scratch.SetParent(smptChildIdx, nmptCurrent);
+							scratch.SetDistance(smptChildIdx, newDist);
 						}
-						if (distFromStart[smptChildIdx] >= oldDist) continue;
 					}
 
-					PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
-					open.emplace(newNode);
+					if (scratch.GetDistance(smptChildIdx) < oldDist) {
+						PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
+						open.emplace(newNode);
+					}
+				} else {
+					// Lazy Theta star*
+					unsigned short newDist = scratch.GetDistance(smptParent.y * mapSize.w + smptParent.x) + Distance(smptParent, smptChild);
+					if (newDist < oldDist) {
+						scratch.SetParent(smptChildIdx, nmptParent);
+						scratch.SetDistance(smptChildIdx, newDist);
+					}
+
+					if (scratch.GetDistance(smptChildIdx) < oldDist) {
+						// Theta-star path if there is LOS
+						// so far the searchmap grid appears too coarse to play on, see #2261
+						//if (!IsWalkableTo(smptParent, smptChild, actorsAreBlocking, caller)) {
+						if (!IsWalkableTo(nmptParent, nmptChild, actorsAreBlocking, caller)) {
+							// Fall back to A-star path
+							scratch.SetDistance(smptChildIdx, std::numeric_limits<unsigned short>::max());
+							// Find already visited neighbour with shortest: path from start + path to child
+							for (size_t j = 0; j < DEGREES_OF_FREEDOM; j++) {
+								NavmapPoint nmptVis(nmptChild.x + 16 * dxAdjacent[j], nmptChild.y + 12 * dyAdjacent[j]);
+								SearchmapPoint smptVis { nmptVis };
+								// Outside map
+								if (outside(smptVis)) continue;
+								// Only consider already visited
+								if (!scratch.IsClosed(smptVis.y * mapSize.w + smptVis.x)) continue;
+
+								unsigned short oldVisDist = scratch.GetDistance(smptChildIdx);
+								newDist = scratch.GetDistance(smptVis.y * mapSize.w + smptVis.x) + Distance(smptVis, smptChild);
+								if (newDist < oldVisDist) {
+									scratch.SetParent(smptChildIdx, nmptVis);
+									scratch.SetDistance(smptChildIdx, newDist);
+								}
+							}
+							if (scratch.GetDistance(smptChildIdx) >= oldDist) continue;
+						}
+
+						PQNode newNode(nmptChild, getHeuristic(smptChild, smptChildIdx));
+						open.emplace(newNode);
+					}
 				}
 			}
 		}
+		return false;
+	};
+
+	// Short hops first try a search limited to the area around both ends,
+	// so they don't wander over the whole map when the direct way is blocked
+	const Region mapRegion(Point(), mapSize);
+	bool foundPath = false;
+	if (hop <= SHORT_HOP_LENGTH) {
+		int margin = hop / 2 + SHORT_HOP_MARGIN + int(size);
+		Region bounds(std::min(smptSource.x, smptDest.x) - margin, std::min(smptSource.y, smptDest.y) - margin,
+			      std::abs(smptDest.x - smptSource.x) + 2 * margin + 1, std::abs(smptDest.y - smptSource.y) + 2 * margin + 1);
+		bounds = bounds.Intersect(mapRegion);
+		if (bounds != mapRegion) {
+			foundPath = search(bounds);
+		}
+	}
+	if (!foundPath) {
+		foundPath = search(mapRegion);
 	}
 
 	if (foundPath) {
@@ -405,8 +554,8 @@ Path Map::FindPath(const Point& s, const Point& d, unsigned int size, unsigned i
 		NavmapPoint nmptCurrent = nmptDest;
 		NavmapPoint nmptParent;
 		SearchmapPoint smptCurrent { nmptCurrent };
-		while (!resultPath || nmptCurrent != parents[smptCurrent.y * mapSize.w + smptCurrent.x]) {
-			nmptParent = parents[smptCurrent.y * mapSize.w + smptCurrent.x];
+		while (!resultPath || nmptCurrent != scratch.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x)) {
+			nmptParent = scratch.GetParent(smptCurrent.y * mapSize.w + smptCurrent.x);
 			PathNode newStep { nmptCurrent, S };
 			// movement in general allows characters to walk backwards given that
 			// the destination is behind the character (within a threshold), and
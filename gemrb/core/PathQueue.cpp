@@ -0,0 +1,104 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "PathQueue.h"
+
+#include "Map.h"
+#include "SubsystemTimer.h"
+
+#include "Scriptable/Actor.h"
+#include "System/ThreadPool.h"
+
+#include <future>
+
+namespace GemRB {
+
+// shared by all maps, they are never updated at the same time
+static ThreadPool& PathWorkers()
+{
+	static ThreadPool workers;
+	return workers;
+}
+
+void PathQueue::Submit(const Actor* actor)
+{
+	requests.push_back(actor->GetGlobalID());
+}
+
+void PathQueue::Solve(Map& map)
+{
+	if (requests.empty()) return;
+	// the worker threads aren't timed, so this covers their searches
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Pathfinding);
+
+	std::vector<Actor*> walkers;
+	for (ieDword id : requests) {
+		Actor* actor = map.GetActorByGlobalID(id);
+		// stopped or got a new path from elsewhere meanwhile
+		if (!actor || !actor->InMove()) continue;
+		if (!actor->PrepareNewPath()) continue;
+		walkers.push_back(actor);
+	}
+	requests.clear();
+	if (walkers.empty()) return;
+
+	// each search sees the searchmap like NewPath would: only its own walker
+	// lifted, everyone else still in the way
+	std::vector<Map::Footprint> footprints(walkers.size());
+	for (size_t i = 0; i < walkers.size(); ++i) {
+		if (walkers[i]->BlocksSearchMap()) {
+			footprints[i] = map.LiftedFootprint(walkers[i]);
+		}
+	}
+	auto plan = [&walkers, &footprints](size_t i) {
+		Map::FootprintView view(footprints[i]);
+		return walkers[i]->PlanNewPath();
+	};
+
+	std::vector<Path> paths(walkers.size());
+	ThreadPool& workers = PathWorkers();
+	if (walkers.size() == 1 || workers.Size() == 1) {
+		for (size_t i = 0; i < walkers.size(); ++i) {
+			paths[i] = plan(i);
+		}
+	} else {
+		std::vector<std::future<void>> done;
+		done.reserve(walkers.size());
+		for (size_t i = 0; i < walkers.size(); ++i) {
+			done.push_back(workers.Submit([&paths, &plan, i]() {
+				paths[i] = plan(i);
+			}));
+		}
+		// let them all finish before rethrowing any errors, they write into paths
+		for (const auto& result : done) {
+			result.wait();
+		}
+		for (auto& result : done) {
+			result.get();
+		}
+	}
+
+	// the searchmap wasn't touched, so the walkers are still marked on it
+	for (size_t i = 0; i < walkers.size(); ++i) {
+		walkers[i]->FinishNewPath(std::move(paths[i]));
+	}
+}
+
+}
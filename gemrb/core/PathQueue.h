@@ -0,0 +1,53 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Deferred repathing for actors that are already walking (see Actor::NewPath)
+// Requests collected during a tick are solved together at its end, on worker
+// threads. Nothing else runs meanwhile, so the searchmap doesn't change under
+// them. Each search lifts only its own walker through a Map::FootprintView,
+// so it gives the same result NewPath would on the main thread, regardless
+// of how the workers get scheduled. The results are then handed
+// out in request order, so the next tick continues with the new paths.
+
+#ifndef PATHQUEUE_H
+#define PATHQUEUE_H
+
+#include "exports.h"
+#include "ie_types.h"
+
+#include <vector>
+
+namespace GemRB {
+
+class Actor;
+class Map;
+
+class GEM_EXPORT PathQueue {
+public:
+	void Submit(const Actor* actor);
+	void Solve(Map& map);
+
+private:
+	std::vector<ieDword> requests; // global IDs, since actors may go away meanwhile
+};
+
+}
+
+#endif
@@ -50,6 +50,11 @@ RNG::RNG()
 	engine.seed(seed);
 }
 
+void RNG::Seed(uint32_t seed) noexcept
+{
+	engine.seed(seed);
+}
+
 /**
  * Singleton.
  */
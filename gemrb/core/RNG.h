@@ -45,6 +45,8 @@ private:
 
 public:
 	static RNG& getInstance();
+	// for reproducible runs, only affects the calling thread
+	void Seed(uint32_t seed) noexcept;
 
 	/**
 	 * It is possible to generate random numbers from [-min, +/-max].
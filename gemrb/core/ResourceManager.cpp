@@ -93,19 +93,68 @@ bool ResourceManager::AddSource(const path_t& path, const std::string& descripti
 		return false;
 	}
 
+	std::lock_guard<std::mutex> lock(indexLock);
 	if (flags & RM_REPLACE_SAME_SOURCE) {
-		for (auto& path2 : searchPath) {
-			if (description == path2->GetDescription()) {
-				path2 = source;
+		for (size_t i = 0; i < searchPath.size(); ++i) {
+			if (description == searchPath[i]->GetDescription()) {
+				searchPath[i] = source;
+				volatileSources[i] = source->IsVolatile();
 				break;
 			}
 		}
 	} else {
 		searchPath.push_back(source);
+		volatileSources.push_back(source->IsVolatile());
 	}
+	lookupIndex.clear();
 	return true;
 }
 
+size_t ResourceManager::LookupKeyHash::operator()(const LookupKey& key) const
+{
+	size_t h = std::hash<std::string>()(key.name);
+	h ^= std::hash<SClass_ID>()(key.type) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	h ^= std::hash<path_t>()(key.ext) + 0x9e3779b9 + (h << 6) + (h >> 2);
+	return h;
+}
+
+template<typename TYPE>
+size_t ResourceManager::FirstIndexedSource(LookupKey&& key, StringView resname, const TYPE& type) const
+{
+	StringToLower(key.name);
+
+	std::lock_guard<std::mutex> lock(indexLock);
+	auto lookup = lookupIndex.find(key);
+	if (lookup != lookupIndex.end()) {
+		return lookup->second;
+	}
+
+	size_t pos = 0;
+	for (; pos < searchPath.size(); ++pos) {
+		if (!volatileSources[pos] && searchPath[pos]->HasResource(resname, type)) {
+			break;
+		}
+	}
+	lookupIndex.emplace(std::move(key), pos);
+	return pos;
+}
+
+size_t ResourceManager::FirstIndexedSource(StringView resname, SClass_ID type) const
+{
+	return FirstIndexedSource(LookupKey { std::string(resname.c_str(), resname.length()), type, path_t() }, resname, type);
+}
+
+size_t ResourceManager::FirstIndexedSource(StringView resname, const ResourceDesc& type) const
+{
+	return FirstIndexedSource(LookupKey { std::string(resname.c_str(), resname.length()), type.GetKeyType(), type.GetExt() }, resname, type);
+}
+
+bool ResourceManager::NeedsLookup(size_t pos, size_t firstIndexed) const
+{
+	// every non-volatile source before the first indexed one is known not to have it
+	return pos >= firstIndexed || volatileSources[pos];
+}
+
 static void PrintPossibleFiles(std::string& buffer, StringView ResRef, const TypeID* type)
 {
 	const std::vector<ResourceDesc>& types = PluginMgr::Get()->GetResourceDesc(type);
@@ -126,12 +175,15 @@ bool ResourceManager::Exists(StringView ResRef, SClass_ID type, bool silent) con
 {
 	if (ResRef.empty())
 		return false;
-	// TODO: check various caches
-	for (const auto& path : searchPath) {
-		if (path->HasResource(ResRef, type)) {
+	size_t firstIndexed = FirstIndexedSource(ResRef, type);
+	for (size_t i = 0; i < firstIndexed; ++i) {
+		if (volatileSources[i] && searchPath[i]->HasResource(ResRef, type)) {
 			return true;
 		}
 	}
+	if (firstIndexed < searchPath.size()) {
+		return true;
+	}
 	if (!silent) {
 		Log(WARNING, "ResourceManager", "'{}.{}' not found...",
 		    ResRef, TypeExt(type));
@@ -143,14 +195,17 @@ bool ResourceManager::Exists(StringView ResRef, const TypeID* type, bool silent)
 {
 	if (ResRef[0] == '\0')
 		return false;
-	// TODO: check various caches
 	const std::vector<ResourceDesc>& types = PluginMgr::Get()->GetResourceDesc(type);
 	for (const auto& type2 : types) {
-		for (const auto& path : searchPath) {
-			if (path->HasResource(ResRef, type2)) {
+		size_t firstIndexed = FirstIndexedSource(ResRef, type2);
+		for (size_t i = 0; i < firstIndexed; ++i) {
+			if (volatileSources[i] && searchPath[i]->HasResource(ResRef, type2)) {
 				return true;
 			}
 		}
+		if (firstIndexed < searchPath.size()) {
+			return true;
+		}
 	}
 	if (!silent) {
 		std::string buffer = fmt::format("Couldn't find '{}'... Tried ", ResRef);
@@ -164,7 +219,11 @@ DataStream* ResourceManager::GetResourceStream(StringView ResRef, SClass_ID type
 {
 	if (ResRef.empty())
 		return nullptr;
-	for (const auto& path : searchPath) {
+	size_t firstIndexed = FirstIndexedSource(ResRef, type);
+	for (size_t i = 0; i < searchPath.size(); ++i) {
+		if (!NeedsLookup(i, firstIndexed)) continue;
+
+		const auto& path = searchPath[i];
 		DataStream* ds = path->GetResource(ResRef, type);
 		if (ds) {
 			if (!silent) {
@@ -194,7 +253,11 @@ ResourceHolder<Resource> ResourceManager::GetResource(StringView ResRef, const T
 	}
 
 	for (const auto& type2 : types2) {
-		for (const auto& path : searchPath) {
+		size_t firstIndexed = FirstIndexedSource(ResRef, type2);
+		for (size_t i = 0; i < searchPath.size(); ++i) {
+			if (!NeedsLookup(i, firstIndexed)) continue;
+
+			const auto& path = searchPath[i];
 			DataStream* str = path->GetResource(ResRef, type2);
 			if (!str) continue;
 
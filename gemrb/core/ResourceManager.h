@@ -30,12 +30,16 @@
 #include "System/VFS.h"
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace GemRB {
 
 #define RM_REPLACE_SAME_SOURCE 1
 
+class ResourceDesc;
 class ResourceSource;
 class TypeID;
 
@@ -67,7 +71,39 @@ private:
 	/** Returns Resource object associated to given resource */
 	ResourceHolder<Resource> GetResource(StringView resname, const TypeID* type, bool silent = false, ieWord prefferedType = 0) const;
 
+	struct LookupKey {
+		std::string name; // lowercased
+		SClass_ID type;
+		path_t ext; // only set for ResourceDesc lookups
+
+		bool operator==(const LookupKey& other) const
+		{
+			return type == other.type && name == other.name && ext == other.ext;
+		}
+	};
+
+	struct LookupKeyHash {
+		size_t operator()(const LookupKey& key) const;
+	};
+
+	/**
+	 * Returns the position of the first non-volatile source in searchPath that has the resource,
+	 * or searchPath.size() if there is none. Results (also negative ones) are remembered until
+	 * the search path changes; volatile sources always have to be asked directly.
+	 */
+	size_t FirstIndexedSource(StringView resname, SClass_ID type) const;
+	size_t FirstIndexedSource(StringView resname, const ResourceDesc& type) const;
+	template<typename TYPE>
+	size_t FirstIndexedSource(LookupKey&& key, StringView resname, const TYPE& type) const;
+	/** Whether the source at pos needs to be asked, knowing the first indexed source */
+	bool NeedsLookup(size_t pos, size_t firstIndexed) const;
+
 	std::vector<PluginHolder<ResourceSource>> searchPath;
+	std::vector<bool> volatileSources; // parallel to searchPath
+
+	// resources are also requested from the audio threads
+	mutable std::mutex indexLock;
+	mutable std::unordered_map<LookupKey, size_t, LookupKeyHash> lookupIndex;
 };
 
 }
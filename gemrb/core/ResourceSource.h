@@ -42,6 +42,8 @@ public:
 	virtual bool HasResource(StringView resname, const ResourceDesc& type) = 0;
 	virtual DataStream* GetResource(StringView resname, SClass_ID type) = 0;
 	virtual DataStream* GetResource(StringView resname, const ResourceDesc& type) = 0;
+	/* whether the contents can change behind our back, so lookups must not be remembered */
+	virtual bool IsVolatile() const { return false; }
 	const std::string& GetDescription() const { return description; }
 
 protected:
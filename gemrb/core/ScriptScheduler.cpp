@@ -0,0 +1,73 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "ScriptScheduler.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+// percent of the budget each class may be started within
+static const EnumArray<ScriptScheduler::Priority, int> shares { 100, 100, 100, 75, 50 };
+
+bool ScriptScheduler::Admit(Priority priority, unsigned int deferrals) noexcept
+{
+	if (budget == clock_t::duration::zero() || priority <= Priority::Combat) {
+		++stats.run[priority];
+		return true;
+	}
+
+	if (spent * 100 < budget * shares[priority]) {
+		++stats.run[priority];
+		return true;
+	}
+
+	if (deferrals >= MAX_DEFERRAL) {
+		++stats.run[priority];
+		++stats.overdue;
+		return true;
+	}
+
+	++stats.deferred[priority];
+	return false;
+}
+
+bool ScriptScheduler::Hold(Priority priority, uint32_t id)
+{
+	if (!collecting || budget == clock_t::duration::zero() || shares[priority] == 100) {
+		return false;
+	}
+
+	held.push_back({ priority, id });
+	return true;
+}
+
+std::vector<ScriptScheduler::Round> ScriptScheduler::TakeHeld()
+{
+	std::vector<Round> rounds;
+	std::swap(rounds, held);
+	// stable, so rounds of the same class keep the area order
+	std::stable_sort(rounds.begin(), rounds.end(), [](const Round& a, const Round& b) {
+		return a.priority < b.priority;
+	});
+	return rounds;
+}
+
+}
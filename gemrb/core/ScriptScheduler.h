@@ -0,0 +1,96 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Per tick time budget for script rounds
+// Scriptables due for a round ask for admission first. The party, fighting
+// actors and area scripts always get it, everyone else only while their
+// share of the budget isn't used up yet. While an area collects its
+// actors' rounds, those with a reduced share are held back and admitted
+// after the rest, most important first, so on-screen actors get to run
+// before the idle ones regardless of their order in the area.
+// Postponed rounds are retried on the following ticks and can't be
+// postponed for more than MAX_DEFERRAL ticks in a row.
+// A budget of 0 disables the whole thing.
+
+#ifndef SCRIPTSCHEDULER_H
+#define SCRIPTSCHEDULER_H
+
+#include "exports.h"
+
+#include "EnumIndex.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace GemRB {
+
+class GEM_EXPORT ScriptScheduler {
+public:
+	enum class Priority : uint8_t {
+		Party,
+		Combat,
+		OnScreen,
+		Triggered,
+		Idle,
+
+		count
+	};
+
+	struct Stats {
+		EnumArray<Priority, uint64_t> run;
+		EnumArray<Priority, uint64_t> deferred;
+		uint64_t overdue = 0; // rounds that ran over budget, since they waited long enough
+	};
+
+	struct Round {
+		Priority priority;
+		uint32_t id; // global ID of the scriptable
+	};
+
+	using clock_t = std::chrono::steady_clock;
+
+	static constexpr unsigned int MAX_DEFERRAL = 15; // a second of game time
+
+	explicit ScriptScheduler(int budget) noexcept
+		: budget(std::chrono::microseconds(budget)) {}
+
+	void NewTick() noexcept { spent = clock_t::duration::zero(); }
+	// deferrals is the number of ticks the round has already been postponed
+	bool Admit(Priority priority, unsigned int deferrals) noexcept;
+	void Collect(bool enable) noexcept { collecting = enable; }
+	// returns true if the round has to wait for TakeHeld
+	bool Hold(Priority priority, uint32_t id);
+	// the held rounds, most important first
+	std::vector<Round> TakeHeld();
+	void Account(clock_t::time_point start) noexcept { spent += clock_t::now() - start; }
+	const Stats& GetStats() const noexcept { return stats; }
+
+private:
+	clock_t::duration budget;
+	clock_t::duration spent = clock_t::duration::zero();
+	Stats stats;
+	bool collecting = false;
+	std::vector<Round> held;
+};
+
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include "voodooconst.h"
 
 #include "DataFileMgr.h"
+#include "Debug.h"
 #include "DialogHandler.h" // checking for dialog
 #include "DisplayMessage.h"
 #include "Game.h"
@@ -249,6 +250,7 @@ std::map<int, ieByte> numWeaponSlots;
 
 //for every game except IWD2 we need to reverse TOHIT
 static int ReverseToHit = true;
+static Actor::EffectCacheStats effectCacheStats;
 static int CheckAbilities = false;
 
 // from FXOpcodes
@@ -353,6 +355,16 @@ void Actor::SetFistStat(ieDword stat)
 	fiststat = stat;
 }
 
+const Actor::EffectCacheStats& Actor::GetEffectCacheStats() noexcept
+{
+	return effectCacheStats;
+}
+
+void Actor::ResetEffectCacheStats() noexcept
+{
+	effectCacheStats = EffectCacheStats();
+}
+
 void Actor::SetDefaultActions(int qslot, ieByte slot1, ieByte slot2, ieByte slot3)
 {
 	QslotTranslation = qslot;
@@ -571,6 +583,9 @@ void Actor::SetCircleSize()
 	int csize = Clamp(anims->GetCircleSize(), 1, MAX_CIRCLE_SIZE) - 1;
 	int selectedIdx = (normalIdx == 0) ? 3 : normalIdx;
 	SetCircle(anims->GetCircleSize(), oscillationFactor, color, core->GroundCircles[csize][normalIdx], core->GroundCircles[csize][selectedIdx]);
+	if (area) {
+		area->UpdateActorGrid(this);
+	}
 }
 
 static void ApplyClabEntry(Actor* actor, const ieVariable& res, bool remove)
@@ -2515,6 +2530,10 @@ bool Actor::SetStat(unsigned int StatIndex, stat_t Value, int pcf)
 	unsigned int previous = GetSafeStat(StatIndex);
 	if (Modified[StatIndex] != Value) {
 		Modified[StatIndex] = Value;
+		// effect replays are checked as a whole in RefreshEffects
+		if (!PrevStats && area && ActorStatIndex::Indexes(StatIndex)) {
+			area->InvalidateActorStats();
+		}
 	}
 	if (previous != Value) {
 		if (pcf) {
@@ -2685,6 +2704,88 @@ Actor::stats_t Actor::ResetStats(bool init)
 	return prev;
 }
 
+// applies the effect queue on top of the freshly reset stats
+// most actors only carry plain stat modifiers from their items, which give the
+// same result tick after tick, so while neither they, the base stats nor the
+// wielded gear change, the outcome of the last full replay is reused
+void Actor::ReplayEffects(bool init)
+{
+	auto& cache = effectCache;
+	bool cacheable = !init && fxqueue.GetReplayKeys(cache.scratch, core->GetGame()->GameTime);
+
+	// fx_ac_vs_damage_type_modifier can depend on these
+	const CREItem* weapon = nullptr;
+	const CREItem* shield = nullptr;
+	if (cacheable) {
+		int slot = Inventory::GetWeaponSlot();
+		if (slot > 0) weapon = inventory.GetSlotItem(slot);
+		slot = inventory.GetShieldSlot();
+		if (slot > 0) shield = inventory.GetSlotItem(slot);
+	}
+
+	bool hit = cacheable && cache.valid && cache.weapon == weapon && cache.shield == shield &&
+		cache.effects == cache.scratch && cache.base == BaseStats;
+	if (hit) {
+		++effectCacheStats.hits;
+	} else if (cacheable) {
+		++effectCacheStats.misses;
+	} else if (!init) {
+		++effectCacheStats.uncacheable;
+	}
+	if (hit && !InDebugMode(DebugMode::EFFECTS)) {
+		Modified = cache.modified;
+		AC = cache.ac;
+		ToHit = cache.toHit;
+		return;
+	}
+
+	if (cacheable) {
+		cache.base = BaseStats;
+	}
+
+	// give the 3ed save bonus before applying the effects, since they may do extra rolls
+	if (third) {
+		Modified[IE_SAVEWILL] += GetAbilityBonus(IE_WIS);
+		Modified[IE_SAVEREFLEX] += GetAbilityBonus(IE_DEX);
+		Modified[IE_SAVEFORTITUDE] += GetAbilityBonus(IE_CON);
+		// paladins add their charisma modifier to all saving throws
+		if (GetPaladinLevel()) {
+			Modified[IE_SAVEWILL] += GetAbilityBonus(IE_CHR);
+			Modified[IE_SAVEREFLEX] += GetAbilityBonus(IE_CHR);
+			Modified[IE_SAVEFORTITUDE] += GetAbilityBonus(IE_CHR);
+		}
+	}
+
+	fxqueue.ApplyAllEffects(this);
+
+	// debug mode: the cache was still valid, so both have to agree
+	if (hit) {
+		for (int i = 0; i < MAX_STATS; ++i) {
+			if (Modified[i] == cache.modified[i]) continue;
+			Log(ERROR, "Actor", "Cached effects of {} are stale, stat {} is {} instead of {}!",
+			    fmt::WideToChar { GetName() }, i, cache.modified[i], Modified[i]);
+		}
+		if (AC != cache.ac) {
+			Log(ERROR, "Actor", "Cached effects of {} are stale, AC is {} instead of {}!",
+			    fmt::WideToChar { GetName() }, cache.ac.GetTotal(), AC.GetTotal());
+		}
+		if (ToHit != cache.toHit) {
+			Log(ERROR, "Actor", "Cached effects of {} are stale, tohit is {} instead of {}!",
+			    fmt::WideToChar { GetName() }, cache.toHit.GetTotal(), ToHit.GetTotal());
+		}
+	}
+
+	cache.valid = cacheable;
+	if (!cacheable) return;
+
+	std::swap(cache.effects, cache.scratch);
+	cache.modified = Modified;
+	cache.ac = AC;
+	cache.toHit = ToHit;
+	cache.weapon = weapon;
+	cache.shield = shield;
+}
+
 /** call this after load, to apply effects */
 void Actor::AddEffects(EffectQueue&& fx)
 {
@@ -2720,20 +2821,7 @@ void Actor::RefreshEffects(bool first, const stats_t& previous)
 		SetLockedPalette(fullwhite);
 	}
 
-	// give the 3ed save bonus before applying the effects, since they may do extra rolls
-	if (third) {
-		Modified[IE_SAVEWILL] += GetAbilityBonus(IE_WIS);
-		Modified[IE_SAVEREFLEX] += GetAbilityBonus(IE_DEX);
-		Modified[IE_SAVEFORTITUDE] += GetAbilityBonus(IE_CON);
-		// paladins add their charisma modifier to all saving throws
-		if (GetPaladinLevel()) {
-			Modified[IE_SAVEWILL] += GetAbilityBonus(IE_CHR);
-			Modified[IE_SAVEREFLEX] += GetAbilityBonus(IE_CHR);
-			Modified[IE_SAVEFORTITUDE] += GetAbilityBonus(IE_CHR);
-		}
-	}
-
-	fxqueue.ApplyAllEffects(this);
+	ReplayEffects(first);
 
 	const Game* game = core->GetGame();
 	if (previous[IE_PUPPETID]) {
@@ -2818,14 +2906,19 @@ void Actor::RefreshEffects(bool first, const stats_t& previous)
 		Modified[IE_NUMBEROFATTACKS] = apr;
 	}
 
+	bool reindex = false;
 	for (int i = 0; i < MAX_STATS; ++i) {
 		if (first || Modified[i] != previous[i]) {
 			PostChangeFunctionType f = post_change_functions[i];
 			if (f) {
 				(*f)(this, previous[i], Modified[i]);
 			}
+			reindex = reindex || ActorStatIndex::Indexes(i);
 		}
 	}
+	if (reindex && area) {
+		area->InvalidateActorStats();
+	}
 
 	// manually update the overlays
 	// we make sure to set them without pcfs, since they would trample each other otherwise
@@ -8145,16 +8238,46 @@ void Actor::SetRunFlags(ieDword flags)
 
 void Actor::NewPath()
 {
-	if (Destination == Pos) return;
-	// WalkTo's and FindPath's first argument is passed by reference
-	// And we don't want to modify Destination so we use a temporary
-	Point savedDest = Destination;
+	if (!PrepareNewPath()) return;
+
+	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
+	FinishNewPath(PlanNewPath());
+}
+
+bool Actor::PrepareNewPath()
+{
+	if (Destination == Pos) return false;
 	if (GetPathTries() > MAX_PATH_TRIES) {
 		ClearPath(true);
 		ResetPathTries();
-		return;
+		return false;
+	}
+
+	// what WalkTo checks
+	ResetPathTries();
+	bool search = !(InternalFlags & IF_REALLYDIED) && walkScale != 0;
+	if (search) {
+		ResetCommentTime();
+		// PrepareWalkTo's argument is passed by reference
+		// And we don't want to modify Destination so we use a temporary
+		Point savedDest = Destination;
+		search = PrepareWalkTo(savedDest);
+	}
+	// like a WalkTo that ended without a path
+	if (!search && !GetPath()) {
+		IncrementPathTries();
 	}
-	WalkTo(savedDest, InternalFlags, pathfindingDistance);
+	return search;
+}
+
+Path Actor::PlanNewPath() const
+{
+	return PlanPath(Destination, pathfindingDistance);
+}
+
+void Actor::FinishNewPath(Path newPath)
+{
+	FollowPath(std::move(newPath), pathfindingDistance);
 	if (!GetPath()) {
 		IncrementPathTries();
 	}
@@ -8932,6 +9055,20 @@ void Actor::GetVerbalConstantSound(ResRef& Sound, Verbal index, bool resolved) c
 	}
 }
 
+void Actor::GetCombatSounds(std::vector<ResRef>& sounds) const
+{
+	static const Verbal combat[] = { Verbal::BattleCry, Verbal::Attack0, Verbal::Damage, Verbal::Die };
+	for (Verbal vb : combat) {
+		ieStrRef strref = GetVerbalConstant(VCMap[vb]);
+		if (strref == ieStrRef::INVALID) continue;
+
+		ResRef sound = core->strings->GetStringBlock(strref).Sound;
+		if (!sound.IsEmpty() && std::find(sounds.begin(), sounds.end(), sound) == sounds.end()) {
+			sounds.push_back(sound);
+		}
+	}
+}
+
 void Actor::SetActionButtonRow(const ActionButtonRow& ar) const
 {
 	for (int i = 0; i < GUIBT_COUNT; i++) {
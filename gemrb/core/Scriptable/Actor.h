@@ -554,6 +554,19 @@ private:
 	bool secondround = false; // true every second round of attack
 	int attacksperround = 0;
 
+	// outcome of the last replay of a cacheable effect queue, see ReplayEffects
+	struct {
+		std::vector<EffectReplayKey> effects;
+		std::vector<EffectReplayKey> scratch;
+		stats_t base {};
+		stats_t modified {};
+		ArmorClass ac;
+		ToHitStats toHit;
+		const CREItem* weapon = nullptr;
+		const CREItem* shield = nullptr;
+		bool valid = false;
+	} effectCache;
+
 	/** paint the actor itself. Called internally by Draw() */
 	void DrawActorSprite(const Point& p, BlitFlags flags,
 			     const std::vector<AnimationPart>& anims, const Color& tint) const;
@@ -604,6 +617,7 @@ private:
 	bool ProcessKillXP(const Actor* killerActor, bool grantXP);
 
 	stats_t ResetStats(bool init);
+	void ReplayEffects(bool init);
 	void RefreshEffects(bool init, const stats_t& prev);
 
 public:
@@ -615,6 +629,14 @@ public:
 	static void SetFistStat(ieDword stat);
 	/** sets game specific default data about action buttons */
 	static void SetDefaultActions(int qslot, ieByte slot1, ieByte slot2, ieByte slot3);
+	/** how often ReplayEffects could reuse its last outcome instead of a full replay */
+	struct EffectCacheStats {
+		uint64_t hits = 0;
+		uint64_t misses = 0; // the effects, base stats or wielded gear changed
+		uint64_t uncacheable = 0; // the queue has effects that always need a full replay
+	};
+	static const EffectCacheStats& GetEffectCacheStats() noexcept;
+	static void ResetEffectCacheStats() noexcept;
 	/** prints useful information on console */
 	std::string dump() const override;
 	/** fixes the feet circle */
@@ -871,6 +893,10 @@ public:
 			 const Color&, int phase = -1) const;
 	bool Schedule(ieDword gametime, bool checkhide) const;
 	void NewPath();
+	/* NewPath split up for PathQueue: checks, the search itself and taking over the result */
+	bool PrepareNewPath();
+	Path PlanNewPath() const;
+	void FinishNewPath(Path newPath);
 	/* overridden method, won't walk if dead */
 	void WalkTo(const Point& Des, ieDword flags, int MinDistance = 0);
 	/* resolve string constant (sound will be altered) */
@@ -878,6 +904,8 @@ public:
 	bool GetSoundFromFile(ResRef& sound, Verbal index) const;
 	bool GetSoundFromINI(ResRef& sound, Verbal index) const;
 	bool GetSoundFrom2DA(ResRef& sound, Verbal index) const;
+	/* adds the strref sounds of the common combat verbal constants */
+	void GetCombatSounds(std::vector<ResRef>& sounds) const;
 	/* start bg1-style banter dialog */
 	void HandleInteractV1(const Actor* target);
 	/* generate party banter, return true if successful */
@@ -185,6 +185,14 @@ void ArmorClass::HandleFxBonus(int mod, bool permanent)
 	}
 }
 
+bool ArmorClass::operator==(const ArmorClass& other) const
+{
+	return total == other.total && natural == other.natural &&
+		deflectionBonus == other.deflectionBonus && armorBonus == other.armorBonus &&
+		shieldBonus == other.shieldBonus && dexterityBonus == other.dexterityBonus &&
+		wisdomBonus == other.wisdomBonus && genericBonus == other.genericBonus;
+}
+
 std::string ArmorClass::dump() const
 {
 	std::string buffer;
@@ -325,6 +333,15 @@ int ToHitStats::GetTotalForAttackNum(unsigned int number) const
 	return total - number * babDecrement;
 }
 
+bool ToHitStats::operator==(const ToHitStats& other) const
+{
+	return total == other.total && base == other.base && babDecrement == other.babDecrement &&
+		weaponBonus == other.weaponBonus && armorBonus == other.armorBonus &&
+		shieldBonus == other.shieldBonus && abilityBonus == other.abilityBonus &&
+		proficiencyBonus == other.proficiencyBonus && genericBonus == other.genericBonus &&
+		fxBonus == other.fxBonus;
+}
+
 std::string ToHitStats::dump() const
 {
 	std::string buffer;
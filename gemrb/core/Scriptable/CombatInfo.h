@@ -58,6 +58,10 @@ public:
 	void HandleFxBonus(int mod, bool permanent);
 	std::string dump() const;
 
+	// compares the values, not the owner
+	bool operator==(const ArmorClass& other) const;
+	bool operator!=(const ArmorClass& other) const { return !(*this == other); }
+
 private:
 	Actor* Owner = nullptr;
 	int total; // modified stat
@@ -111,6 +115,10 @@ public:
 	void HandleFxBonus(int mod, bool permanent);
 	std::string dump() const;
 
+	// compares the values, not the owner
+	bool operator==(const ToHitStats& other) const;
+	bool operator!=(const ToHitStats& other) const { return !(*this == other); }
+
 private:
 	Actor* Owner = nullptr;
 	int total; // modified stat, now really containing all the boni
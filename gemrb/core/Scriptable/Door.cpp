@@ -71,10 +71,19 @@ Door::Door(Holder<TileOverlay> Overlay, DoorTrigger&& trigger)
 
 void Door::ImpedeBlocks(const std::vector<SearchmapPoint>& points, PathMapFlags value) const
 {
+	if (points.empty()) return;
+
+	SearchmapPoint min = points[0];
+	SearchmapPoint max = points[0];
 	for (const SearchmapPoint& point : points) {
 		PathMapFlags tmp = area->tileProps.QuerySearchMap(point) & PathMapFlags::NOTDOOR;
 		area->tileProps.PaintSearchMap(point, tmp | value);
+		min.x = std::min(min.x, point.x);
+		min.y = std::min(min.y, point.y);
+		max.x = std::max(max.x, point.x);
+		max.y = std::max(max.y, point.y);
 	}
+	area->InvalidateSearchMap(Region(min.x, min.y, max.x - min.x + 1, max.y - min.y + 1));
 }
 
 void Door::UpdateDoor()
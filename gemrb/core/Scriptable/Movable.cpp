@@ -291,6 +291,9 @@ void Movable::DoStep(unsigned int walkScale, ieDword time)
 	Pos.y += dy;
 	oldPos = Pos;
 	SMPos = SearchmapPoint(Pos);
+	if (actor) {
+		area->UpdateActorGrid(actor);
+	}
 	if (actor && blocksSearch) {
 		auto flag = actor->IsPartyMember() ? PathMapFlags::PC : PathMapFlags::NPC;
 		area->tileProps.PaintSearchMap(SMPos, circleSize, flag);
@@ -335,35 +338,52 @@ void Movable::AddWayPoint(const Point& Des)
 // This function is called at each tick if an actor is following another actor
 // Therefore it's rate-limited to avoid actors being stuck as they keep pathfinding
 void Movable::WalkTo(const Point& Des, int distance)
+{
+	if (!PrepareWalkTo(Des)) return;
+
+	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
+	FollowPath(PlanPath(Des, distance), distance);
+}
+
+// the checks of WalkTo before searching, returns false if no search is needed
+bool Movable::PrepareWalkTo(const Point& Des)
 {
 	// Only rate-limit when moving
 	if (path && prevTicks && Ticks < prevTicks + 2) {
-		return;
+		return false;
 	}
 
-	const Actor* actor = Scriptable::As<Actor>(this);
-
 	prevTicks = Ticks;
 	Destination = Des;
 	if (pathAbandoned) {
+		const Actor* actor = Scriptable::As<Actor>(this);
 		Log(DEBUG, "WalkTo", "{}: Path was just abandoned", fmt::WideToChar { actor->GetShortName() });
 		ClearPath(true);
-		return;
+		return false;
 	}
 
 	if (Pos.x / 16 == Des.x / 16 && Pos.y / 12 == Des.y / 12) {
 		ClearPath(true);
 		SetStance(IE_ANI_HEAD_TURN);
-		return;
+		return false;
 	}
+	return true;
+}
 
-	if (BlocksSearchMap()) area->ClearSearchMapFor(this);
+// the search part of WalkTo, doesn't change anything, so it can also run on a PathQueue worker
+Path Movable::PlanPath(const Point& Des, int distance) const
+{
+	const Actor* actor = Scriptable::As<Actor>(this);
 	Path newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT | PF_ACTORS_ARE_BLOCKING, actor);
 	if (!newPath && actor && actor->ValidTarget(GA_CAN_BUMP)) {
 		Log(DEBUG, "WalkTo", "{} re-pathing ignoring actors", fmt::WideToChar { actor->GetShortName() });
 		newPath = area->FindPath(Pos, Des, circleSize, distance, PF_SIGHT, actor);
 	}
+	return newPath;
+}
 
+void Movable::FollowPath(Path newPath, int distance)
+{
 	if (newPath) {
 		ClearPath(false);
 		path = std::move(newPath);
@@ -110,6 +110,9 @@ public:
 	int GetRandomWalkCounter() const { return randomWalkCounter; };
 	void MoveLine(int steps, orient_t Orient);
 	void WalkTo(const Point& Des, int MinDistance = 0);
+	bool PrepareWalkTo(const Point& Des);
+	Path PlanPath(const Point& Des, int MinDistance) const;
+	void FollowPath(Path newPath, int MinDistance);
 	void MoveTo(const Point& Des);
 	void Stop(int flags = 0) override;
 	void ClearPath(bool resetDestination = true);
@@ -30,6 +30,7 @@
 #include "Map.h"
 #include "Projectile.h"
 #include "Spell.h"
+#include "SubsystemTimer.h"
 
 #include "GUI/GameControl.h"
 #include "GameScript/GSUtils.h"
@@ -132,6 +133,15 @@ void Scriptable::SetMap(Map* map)
 	area = map;
 }
 
+void Scriptable::SetPos(const NavmapPoint& pos)
+{
+	Pos = pos;
+	SMPos = SearchmapPoint(pos);
+	if (area && Type == ST_ACTOR) {
+		area->UpdateActorGrid(static_cast<const Actor*>(this));
+	}
+}
+
 //ai is nonzero if this is an actor currently in the party
 //if the script level is AI_SCRIPT_LEVEL, then we need to
 //load an AI script (.bs) instead of (.bcs)
@@ -205,7 +215,8 @@ void Scriptable::TickScripting()
 {
 	// Stagger script updates.
 	// but not for just loaded area scripts, ensuring they run first
-	if (Ticks % 16 != globalID % 16 && (Type != ST_AREA || Ticks > 1)) {
+	// and not for rounds the scheduler postponed, they're already late
+	if (!DeferredTicks && Ticks % 16 != globalID % 16 && (Type != ST_AREA || Ticks > 1)) {
 		return;
 	}
 
@@ -233,7 +244,8 @@ void Scriptable::TickScripting()
 	}
 	// also force it for on-screen actors
 	Region vp = core->GetGameControl()->Viewport();
-	if (!needsUpdate && vp.PointInside(Pos)) {
+	bool onScreen = vp.PointInside(Pos);
+	if (onScreen) {
 		needsUpdate = true;
 	}
 
@@ -244,9 +256,27 @@ void Scriptable::TickScripting()
 
 	if (!needsUpdate) {
 		IdleTicks++;
+		DeferredTicks = 0;
 		return;
 	}
 
+	ScriptScheduler::Priority priority = GetScriptPriority(onScreen);
+	// the area runs it once its more important rounds are done
+	if (core->GetGame()->scriptScheduler.Hold(priority, GetGlobalID())) {
+		return;
+	}
+	StartScriptRound(priority);
+}
+
+void Scriptable::StartScriptRound(ScriptScheduler::Priority priority)
+{
+	ScriptScheduler& scheduler = core->GetGame()->scriptScheduler;
+	if (!scheduler.Admit(priority, DeferredTicks)) {
+		DeferredTicks++;
+		return;
+	}
+	DeferredTicks = 0;
+
 	if (!triggers.empty()) {
 		TriggerCountdown = 5;
 	}
@@ -256,7 +286,27 @@ void Scriptable::TickScripting()
 		TriggerCountdown--;
 	}
 
+	auto start = ScriptScheduler::clock_t::now();
+	SubsystemTimer timer(SubsystemTimer::Subsystem::Scripts);
 	ExecuteScript(MAX_SCRIPTS);
+	scheduler.Account(start);
+}
+
+ScriptScheduler::Priority Scriptable::GetScriptPriority(bool onScreen) const
+{
+	const Actor* actor = Scriptable::As<Actor>(this);
+	if (!actor) {
+		// area and global scripts drive the plot, don't hold them back
+		if (Type == ST_AREA || Type == ST_GLOBAL) return ScriptScheduler::Priority::Party;
+	} else if (actor->InParty) {
+		return ScriptScheduler::Priority::Party;
+	} else if (objects.LastTarget || (core->GetGame()->CombatCounter && actor->GetStat(IE_EA) >= EA_EVILCUTOFF)) {
+		return ScriptScheduler::Priority::Combat;
+	}
+
+	if (onScreen) return ScriptScheduler::Priority::OnScreen;
+	if (!triggers.empty() || TriggerCountdown > 0) return ScriptScheduler::Priority::Triggered;
+	return ScriptScheduler::Priority::Idle;
 }
 
 void Scriptable::ExecuteScript(int scriptCount)
@@ -26,6 +26,7 @@
 
 #include "OverHeadText.h"
 #include "PathFinder.h"
+#include "ScriptScheduler.h"
 
 #include <list>
 #include <map>
@@ -297,6 +298,8 @@ public:
 	ieDword ScriptTicks = 0;
 	// The number of times since TickScripting() tried to do anything.
 	ieDword IdleTicks = 0;
+	// The number of ticks the pending script round was postponed, see ScriptScheduler.
+	ieDword DeferredTicks = 0;
 	// The number of ticks since the last spellcast
 	ieDword AuraCooldown = 0;
 	// The countdown for forced activation by triggers.
@@ -367,6 +370,8 @@ public:
 	bool IsPC() const;
 	virtual void Update();
 	void TickScripting();
+	void StartScriptRound(ScriptScheduler::Priority priority);
+	ScriptScheduler::Priority GetScriptPriority(bool onScreen) const;
 	virtual void ExecuteScript(int scriptCount);
 	void AddAction(std::string actStr);
 	void AddAction(Action* aC);
@@ -413,11 +418,7 @@ public:
 	unsigned int GetVisualRange() const;
 	ieDword GetLocal(const ieVariable& key, ieDword fallback) const;
 	virtual std::string dump() const = 0;
-	void SetPos(const NavmapPoint& pos)
-	{
-		Pos = pos;
-		SMPos = SearchmapPoint(pos);
-	};
+	void SetPos(const NavmapPoint& pos);
 
 private:
 	/* used internally to handle start of spellcasting */
@@ -20,8 +20,27 @@
 
 #include "SoundMgr.h"
 
+#include "Streams/DataStream.h"
+
 namespace GemRB {
 
 const TypeID SoundMgr::ID = { "SoundMgr" };
 
+std::vector<char> SoundMgr::ReadEncoded() const
+{
+	std::vector<char> data;
+	if (!str) {
+		return data;
+	}
+
+	strpos_t pos = str->GetPos();
+	data.resize(str->Size());
+	str->Seek(0, GEM_STREAM_START);
+	if (str->Read(data.data(), data.size()) != static_cast<strret_t>(data.size())) {
+		data.clear();
+	}
+	str->Seek(pos, GEM_STREAM_START);
+	return data;
+}
+
 }
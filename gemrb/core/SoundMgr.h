@@ -23,6 +23,8 @@
 
 #include "Resource.h"
 
+#include <vector>
+
 namespace GemRB {
 
 /**
@@ -61,6 +63,8 @@ public:
 	{
 		return samples;
 	}
+	// the whole resource as stored, eg. ACM; doesn't disturb the decoding
+	std::vector<char> ReadEncoded() const;
 
 protected:
 	size_t samples = 0;
@@ -0,0 +1,192 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Uniform grid bucketing objects by position, so proximity queries only
+// have to look at the few cells around the point of interest.
+// Only the position itself is indexed, callers that care about object
+// extents have to grow their query areas accordingly.
+// Query results come back in insertion order, so they can stand in for
+// a linear scan of a container that is only ever appended to.
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include "Region.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+template<typename T>
+class SpatialGrid {
+public:
+	explicit SpatialGrid(const Size& cellSize) noexcept
+		: cellSize(cellSize) {}
+
+	// adds the object or, if it is already known, just moves it
+	void Insert(T* item, const Point& pos)
+	{
+		auto it = entries.find(item);
+		if (it != entries.end()) {
+			Relocate(it->second, item, pos);
+			return;
+		}
+
+		Entry entry { CellKey(pos), nextSerial++ };
+		cells[entry.cell].emplace_back(entry.serial, item);
+		entries.emplace(item, entry);
+	}
+
+	// unknown objects are ignored
+	void Move(const T* item, const Point& pos)
+	{
+		auto it = entries.find(item);
+		if (it != entries.end()) {
+			Relocate(it->second, item, pos);
+		}
+	}
+
+	void Remove(const T* item)
+	{
+		auto it = entries.find(item);
+		if (it == entries.end()) return;
+
+		Unlink(it->second.cell, item);
+		entries.erase(it);
+	}
+
+	void Clear() noexcept
+	{
+		cells.clear();
+		entries.clear();
+	}
+
+	bool Contains(const T* item) const
+	{
+		return entries.count(item) != 0;
+	}
+
+	size_t Count() const noexcept
+	{
+		return entries.size();
+	}
+
+	// all objects in cells touching the area (a superset of those inside it)
+	std::vector<T*> Query(const Region& area) const
+	{
+		std::vector<std::pair<uint64_t, T*>> found;
+		if (area.w < 0 || area.h < 0 || entries.empty()) return {};
+
+		int x1 = CellCoord(area.x, cellSize.w);
+		int y1 = CellCoord(area.y, cellSize.h);
+		int x2 = CellCoord(area.x + area.w, cellSize.w);
+		int y2 = CellCoord(area.y + area.h, cellSize.h);
+
+		uint64_t span = uint64_t(x2 - x1 + 1) * uint64_t(y2 - y1 + 1);
+		if (span > cells.size()) {
+			// huge areas: cheaper to filter the occupied cells
+			for (const auto& cell : cells) {
+				int x = int(uint32_t(cell.first >> 32));
+				int y = int(uint32_t(cell.first));
+				if (x < x1 || x > x2 || y < y1 || y > y2) continue;
+				found.insert(found.end(), cell.second.begin(), cell.second.end());
+			}
+		} else {
+			for (int y = y1; y <= y2; ++y) {
+				for (int x = x1; x <= x2; ++x) {
+					auto it = cells.find(MakeKey(x, y));
+					if (it == cells.end()) continue;
+					found.insert(found.end(), it->second.begin(), it->second.end());
+				}
+			}
+		}
+
+		std::sort(found.begin(), found.end(), [](const std::pair<uint64_t, T*>& a, const std::pair<uint64_t, T*>& b) {
+			return a.first < b.first;
+		});
+		std::vector<T*> items;
+		items.reserve(found.size());
+		for (const auto& entry : found) {
+			items.push_back(entry.second);
+		}
+		return items;
+	}
+
+private:
+	struct Entry {
+		uint64_t cell;
+		uint64_t serial;
+	};
+
+	static int CellCoord(int pos, int size) noexcept
+	{
+		// round towards negative infinity, positions may be off the map
+		return pos >= 0 ? pos / size : -((size - 1 - pos) / size);
+	}
+
+	static uint64_t MakeKey(int x, int y) noexcept
+	{
+		return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+	}
+
+	uint64_t CellKey(const Point& pos) const noexcept
+	{
+		return MakeKey(CellCoord(pos.x, cellSize.w), CellCoord(pos.y, cellSize.h));
+	}
+
+	void Relocate(Entry& entry, const T* item, const Point& pos)
+	{
+		uint64_t cell = CellKey(pos);
+		if (cell == entry.cell) return;
+
+		T* object = Unlink(entry.cell, item);
+		entry.cell = cell;
+		cells[cell].emplace_back(entry.serial, object);
+	}
+
+	T* Unlink(uint64_t cell, const T* item)
+	{
+		auto it = cells.find(cell);
+		auto& bucket = it->second;
+		auto slot = std::find_if(bucket.begin(), bucket.end(), [item](const std::pair<uint64_t, T*>& e) {
+			return e.second == item;
+		});
+		T* object = slot->second;
+		*slot = bucket.back();
+		bucket.pop_back();
+		if (bucket.empty()) {
+			cells.erase(it);
+		}
+		return object;
+	}
+
+	Size cellSize;
+	uint64_t nextSerial = 0;
+	std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, T*>>> cells;
+	std::unordered_map<const T*, Entry> entries;
+};
+
+}
+
+#endif
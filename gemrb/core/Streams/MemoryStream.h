@@ -39,6 +39,8 @@ public:
 	strret_t Read(void* dest, strpos_t length) override;
 	strret_t Write(const void* src, strpos_t length) override;
 	strret_t Seek(stroff_t pos, strpos_t startpos) override;
+
+	const char* GetData() const noexcept { return data; }
 };
 
 }
@@ -0,0 +1,52 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2003 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "MemoryViewStream.h"
+
+#include <cassert>
+
+namespace GemRB {
+
+MemoryViewStream::MemoryViewStream(std::shared_ptr<const MemoryStream> backingStream, strpos_t startPos, strpos_t streamSize)
+	: MemoryStream(backingStream->originalfile, const_cast<char*>(backingStream->GetData()) + startPos, streamSize),
+	  backing(std::move(backingStream))
+{
+	assert(startPos + streamSize <= backing->Size());
+	filename = backing->filename;
+}
+
+MemoryViewStream::~MemoryViewStream()
+{
+	// the buffer belongs to the backing stream
+	data = nullptr;
+}
+
+DataStream* MemoryViewStream::Clone() const noexcept
+{
+	strpos_t startPos = data - backing->GetData();
+	return new MemoryViewStream(backing, startPos, size + (Encrypted ? 2 : 0));
+}
+
+strret_t MemoryViewStream::Write(const void* /*src*/, strpos_t /*length*/)
+{
+	return Error;
+}
+
+}
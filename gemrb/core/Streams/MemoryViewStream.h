@@ -0,0 +1,48 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2003 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef MEMORYVIEWSTREAM_H
+#define MEMORYVIEWSTREAM_H
+
+#include "exports.h"
+
+#include "MemoryStream.h"
+
+#include <memory>
+
+namespace GemRB {
+
+// read-only window into a buffer owned by another MemoryStream (usually a mapped archive)
+// the backing stream is shared, so views and their clones never copy or reopen anything
+class GEM_EXPORT MemoryViewStream : public MemoryStream {
+private:
+	std::shared_ptr<const MemoryStream> backing;
+
+public:
+	MemoryViewStream(std::shared_ptr<const MemoryStream> backing, strpos_t startPos, strpos_t streamSize);
+	~MemoryViewStream() override;
+	DataStream* Clone() const noexcept override;
+
+	strret_t Write(const void* src, strpos_t length) override;
+};
+
+}
+
+#endif
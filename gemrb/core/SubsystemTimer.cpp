@@ -0,0 +1,74 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SubsystemTimer.h"
+
+namespace GemRB {
+
+// timers only run on the thread that enabled them, the game loop; work it hands
+// off (eg. PathQueue solving on worker threads) is timed around the hand-off instead
+static thread_local bool enabled = false;
+static thread_local EnumArray<SubsystemTimer::Subsystem, unsigned int> depth;
+static SubsystemTimer::Totals totals;
+
+SubsystemTimer::SubsystemTimer(Subsystem subsystem) noexcept
+	: subsystem(subsystem)
+{
+	if (!enabled) return;
+
+	outermost = depth[subsystem]++ == 0;
+	if (outermost) {
+		start = clock_t::now();
+	}
+}
+
+SubsystemTimer::~SubsystemTimer() noexcept
+{
+	if (!enabled || !depth[subsystem]) return;
+
+	--depth[subsystem];
+	if (outermost) {
+		totals.time[subsystem] += clock_t::now() - start;
+		++totals.calls[subsystem];
+	}
+}
+
+void SubsystemTimer::Enable(bool enable) noexcept
+{
+	enabled = enable;
+}
+
+void SubsystemTimer::Reset() noexcept
+{
+	totals = Totals();
+}
+
+const SubsystemTimer::Totals& SubsystemTimer::GetTotals() noexcept
+{
+	return totals;
+}
+
+const char* SubsystemTimer::Name(Subsystem subsystem) noexcept
+{
+	static const EnumArray<Subsystem, const char*> names { "scripts", "effects", "pathfinding", "projectiles" };
+	return names[subsystem];
+}
+
+}
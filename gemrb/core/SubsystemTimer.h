@@ -0,0 +1,75 @@
+/* GemRB - Engine Made with preRendered Background
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Wall time spent in the big per tick subsystems, for the benchmark mode
+// Scopes are timed inclusively, so eg. the pathfinding done on behalf of a
+// script action also counts towards the scripts. Nested scopes of the same
+// subsystem are only counted once. Disabled timers cost a branch.
+// Only the thread that enabled the timers is timed.
+
+#ifndef SUBSYSTEMTIMER_H
+#define SUBSYSTEMTIMER_H
+
+#include "exports.h"
+
+#include "EnumIndex.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace GemRB {
+
+class GEM_EXPORT SubsystemTimer {
+public:
+	enum class Subsystem : uint8_t {
+		Scripts,
+		Effects,
+		Pathfinding,
+		Projectiles,
+
+		count
+	};
+
+	using clock_t = std::chrono::steady_clock;
+
+	struct Totals {
+		EnumArray<Subsystem, clock_t::duration> time;
+		EnumArray<Subsystem, uint64_t> calls;
+	};
+
+	explicit SubsystemTimer(Subsystem subsystem) noexcept;
+	SubsystemTimer(const SubsystemTimer&) = delete;
+	~SubsystemTimer() noexcept;
+	SubsystemTimer& operator=(const SubsystemTimer&) = delete;
+
+	static void Enable(bool enable) noexcept;
+	static void Reset() noexcept;
+	static const Totals& GetTotals() noexcept;
+	static const char* Name(Subsystem subsystem) noexcept;
+
+private:
+	Subsystem subsystem;
+	bool outermost = false;
+	clock_t::time_point start;
+};
+
+}
+
+#endif
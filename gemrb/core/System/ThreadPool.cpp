@@ -0,0 +1,80 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "System/ThreadPool.h"
+
+#include <algorithm>
+
+namespace GemRB {
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+{
+	if (numThreads == 0) {
+		numThreads = HardwareThreads();
+	}
+
+	workers.reserve(numThreads);
+	for (unsigned int i = 0; i < numThreads; ++i) {
+		workers.emplace_back(&ThreadPool::Work, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lk(queueLock);
+		running = false;
+		tasks.clear();
+	}
+	cv.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+unsigned int ThreadPool::HardwareThreads()
+{
+	return std::max(1U, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lk(queueLock);
+		tasks.push_back(std::move(task));
+	}
+	cv.notify_one();
+}
+
+void ThreadPool::Work()
+{
+	while (true) {
+		std::unique_lock<std::mutex> lk(queueLock);
+		cv.wait(lk, [this]() { return !tasks.empty() || !running; });
+		if (!running) {
+			return;
+		}
+		auto task = std::move(tasks.front());
+		tasks.pop_front();
+		lk.unlock();
+
+		task();
+	}
+}
+
+}
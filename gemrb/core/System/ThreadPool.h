@@ -0,0 +1,72 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "exports.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+// a fixed set of worker threads running queued tasks in submission order
+// tasks must not wait on other tasks of the same pool
+// queued, but not yet started tasks are dropped on destruction (their futures report a broken promise)
+class GEM_EXPORT ThreadPool {
+public:
+	// 0 picks one thread per hardware thread
+	explicit ThreadPool(unsigned int numThreads = 0);
+	ThreadPool(const ThreadPool&) = delete;
+	~ThreadPool();
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template<typename F, typename R = decltype(std::declval<F&>()())>
+	std::future<R> Submit(F&& func)
+	{
+		auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+		std::future<R> result = task->get_future();
+		Enqueue([task]() { (*task)(); });
+		return result;
+	}
+
+	unsigned int Size() const { return static_cast<unsigned int>(workers.size()); }
+	static unsigned int HardwareThreads();
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex queueLock;
+	std::condition_variable cv;
+	bool running = true;
+
+	void Enqueue(std::function<void()> task);
+	void Work();
+};
+
+}
+
+#endif
@@ -34,6 +34,7 @@
 
 #include "Strings/StringView.h"
 
+#include <limits>
 #include <memory>
 
 namespace GemRB {
@@ -75,10 +76,32 @@ public:
 		return strtounsigned<RET_T>(QueryField(row, column).c_str());
 	}
 
+	/** Parses a field like strtol, false if it isn't a number at all.
+	 * Tables may keep the parsed values around. */
+	virtual bool QueryNumber(index_t row, index_t column, long& value) const
+	{
+		return valid_signednumber(QueryField(row, column).c_str(), value);
+	}
+
+	bool QueryNumber(const key_t& row, const key_t& column, long& value) const
+	{
+		return QueryNumber(GetRowIndex(row), GetColumnIndex(column), value);
+	}
+
 	template<typename RET_T, typename ROW_T, typename COL_T>
 	RET_T QueryFieldSigned(const ROW_T& row, const COL_T& column) const
 	{
-		return strtosigned<RET_T>(QueryField(row, column).c_str());
+		static_assert(std::is_signed<RET_T>::value, "Type must be signed");
+		long value = 0;
+		QueryNumber(row, column, value);
+		// clamp like strtosigned
+		if (value > std::numeric_limits<RET_T>::max()) {
+			return std::numeric_limits<RET_T>::max();
+		}
+		if (value < std::numeric_limits<RET_T>::min()) {
+			return std::numeric_limits<RET_T>::min();
+		}
+		return static_cast<RET_T>(value);
 	}
 
 	template<typename ROW_T, typename COL_T>
@@ -34,7 +34,54 @@ void TileOverlay::AddTile(Tile&& tile)
 	tiles.push_back(std::move(tile));
 }
 
-void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr>& overlays, BlitFlags flags) const
+void TileOverlay::DrawTile(const Tile& tile, const CachedTile& frames, const Point& p, BlitFlags flags, const Color& tint, bool layeredWater) const
+{
+	// this is the base terrain tile
+	VideoDriver->BlitGameSprite(frames.base, p, flags, tint);
+
+	if (!frames.overlaid) {
+		return;
+	}
+
+	int mask = 2;
+	for (const Holder<Sprite2D>& overlay : overlayFrames) {
+		if (overlay && tile.om & mask) {
+			//draw overlay tiles, they should be half transparent except for BG1
+			BlitFlags transFlag = layeredWater ? BlitFlags::HALFTRANS : BlitFlags::NONE;
+			// this is the water (or whatever)
+			VideoDriver->BlitGameSprite(overlay, p, flags | transFlag, tint);
+
+			// this is the mask to blend the terrain tile with the water
+			// in BG1 it is the terrain tile itself
+			if (frames.mask) {
+				VideoDriver->BlitGameSprite(frames.mask, p, flags | BlitFlags::BLENDED, tint);
+			}
+		}
+		mask <<= 1;
+	}
+}
+
+// moves the still visible part of the cached terrain into place
+bool TileOverlay::ScrollCache(const Region& viewport)
+{
+	Point shift = cachedViewport.origin - viewport.origin;
+	if (std::abs(shift.x) >= viewport.w || std::abs(shift.y) >= viewport.h) {
+		return false;
+	}
+
+	if (!scrollBuffer || scrollBuffer->Size() != viewport.size) {
+		scrollBuffer = VideoDriver->CreateBuffer(Region(Point(), viewport.size), Video::BufferFormat::DISPLAY_ALPHA);
+		if (!scrollBuffer) return false;
+	}
+
+	std::swap(terrainCache, scrollBuffer);
+	VideoDriver->PushDrawingBuffer(terrainCache);
+	VideoDriver->BlitVideoBuffer(scrollBuffer, shift, BlitFlags::NONE);
+	VideoDriver->PopDrawingBuffer();
+	return true;
+}
+
+void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr>& overlays, BlitFlags flags)
 {
 	// determine which tiles are visible
 	int sx = std::max(viewport.x / 64, 0);
@@ -49,6 +96,49 @@ void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr>& over
 		flags |= BlitFlags::COLOR_MOD;
 	}
 	const Color tintcol = globalTint ? *globalTint : Color();
+	bool layeredWater = core->HasFeature(GFFlags::LAYERED_WATER_TILES);
+
+	// the overlays use only 1x1 tiles, so their frames are the same for every tile
+	std::vector<Holder<Sprite2D>> frames(overlays.size() > 1 ? overlays.size() - 1 : 0);
+	for (size_t z = 1; z < overlays.size(); ++z) {
+		const auto& ov = overlays[z];
+		if (ov && !ov->tiles.empty()) {
+			frames[z - 1] = ov->tiles[0].GetAnimation(0)->NextFrame();
+		}
+	}
+	// tiles with any of these overlays have to be redrawn
+	int changedOverlays = 0;
+	for (size_t z = 0; z < frames.size(); ++z) {
+		if (z >= overlayFrames.size() || frames[z] != overlayFrames[z]) {
+			changedOverlays |= 2 << z;
+		}
+	}
+	overlayFrames = std::move(frames);
+
+	// the cache can only stand in for the tiles when they cover the whole viewport
+	Region mapArea(0, 0, size.w * 64, size.h * 64);
+	bool useCache = mapArea.RectInside(viewport) && !viewport.size.IsInvalid();
+	bool redrawAll = cachedTiles.size() != tiles.size() || flags != cachedFlags || tintcol != cachedTint;
+	if (useCache && (!terrainCache || terrainCache->Size() != viewport.size)) {
+		terrainCache = VideoDriver->CreateBuffer(Region(Point(), viewport.size), Video::BufferFormat::DISPLAY_ALPHA);
+		useCache = terrainCache != nullptr;
+		redrawAll = true;
+	}
+
+	Region screenClip = VideoDriver->GetScreenClip();
+	if (useCache) {
+		// the cached terrain must be complete, whatever part of the screen is being redrawn
+		VideoDriver->SetScreenClip(nullptr);
+		if (!redrawAll && cachedViewport.origin != viewport.origin) {
+			redrawAll = !ScrollCache(viewport);
+		}
+		if (redrawAll) {
+			cachedTiles.assign(tiles.size(), CachedTile());
+		}
+		VideoDriver->PushDrawingBuffer(terrainCache);
+	} else {
+		cachedTiles.clear();
+	}
 
 	for (int y = sy; y < dy && y < size.h; y++) {
 		for (int x = sx; x < dx && x < size.w; x++) {
@@ -58,43 +148,44 @@ void TileOverlay::Draw(const Region& viewport, std::vector<TileOverlayPtr>& over
 			Animation* anim = tile.GetAnimation();
 			assert(anim);
 
-			// this is the base terrain tile
-			Point p = Point(x * 64, y * 64) - viewport.origin;
-			VideoDriver->BlitGameSprite(anim->NextFrame(), p, flags, tintcol);
+			CachedTile tileFrames;
+			tileFrames.base = anim->NextFrame();
+			if (tile.om && !tile.tileIndex) {
+				tileFrames.overlaid = true;
+				// the mask to blend the terrain tile with the water for everything but BG1
+				Animation* maskAnim = layeredWater ? tile.GetAnimation(1) : tile.GetAnimation(0);
+				if (maskAnim) {
+					tileFrames.mask = maskAnim->NextFrame();
+				}
+			}
 
-			if (!tile.om || tile.tileIndex) {
+			Point p = Point(x * 64, y * 64) - viewport.origin;
+			if (!useCache) {
+				DrawTile(tile, tileFrames, p, flags, tintcol, layeredWater);
 				continue;
 			}
 
-			int mask = 2;
-			for (size_t z = 1; z < overlays.size(); ++z) {
-				const auto& ov = overlays[z];
-				if (ov && !ov->tiles.empty()) {
-					const Tile& ovtile = ov->tiles[0]; //allow only 1x1 tiles now
-					if (tile.om & mask) {
-						//draw overlay tiles, they should be half transparent except for BG1
-						BlitFlags transFlag = (core->HasFeature(GFFlags::LAYERED_WATER_TILES)) ? BlitFlags::HALFTRANS : BlitFlags::NONE;
-						// this is the water (or whatever)
-						VideoDriver->BlitGameSprite(ovtile.GetAnimation(0)->NextFrame(), p, flags | transFlag, tintcol);
-
-						if (core->HasFeature(GFFlags::LAYERED_WATER_TILES)) {
-							Animation* anim1 = tile.GetAnimation(1);
-							if (anim1) {
-								// this is the mask to blend the terrain tile with the water for everything but BG1
-								VideoDriver->BlitGameSprite(anim1->NextFrame(), p,
-											    flags | BlitFlags::BLENDED, tintcol);
-							}
-						} else {
-							// in BG 1 this is the mask to blend the terrain tile with the water
-							VideoDriver->BlitGameSprite(tile.GetAnimation(0)->NextFrame(), p,
-										    flags | BlitFlags::BLENDED, tintcol);
-						}
-					}
-				}
-				mask <<= 1;
+			// skip tiles that look the same as last time and were already fully on screen
+			CachedTile& cached = cachedTiles[(y * size.w) + x];
+			Region visible = Region(Point(x * 64, y * 64), Size(64, 64)).Intersect(viewport);
+			bool overlayChanged = tileFrames.overlaid && (tile.om & changedOverlays);
+			if (redrawAll || !(cached == tileFrames) || overlayChanged || !cachedViewport.RectInside(visible)) {
+				terrainCache->Clear(Region(p, Size(64, 64)));
+				DrawTile(tile, tileFrames, p, flags, tintcol, layeredWater);
+				cached = tileFrames;
 			}
 		}
 	}
+
+	if (useCache) {
+		VideoDriver->PopDrawingBuffer();
+		VideoDriver->SetScreenClip(&screenClip);
+		VideoDriver->BlitVideoBuffer(terrainCache, Point(), BlitFlags::NONE);
+
+		cachedViewport = viewport;
+		cachedFlags = flags;
+		cachedTint = tintcol;
+	}
 }
 
 }
@@ -25,6 +25,8 @@
 
 #include "Tile.h"
 
+#include "Video/Video.h"
+
 #include <vector>
 
 namespace GemRB {
@@ -34,6 +36,32 @@ public:
 	Size size;
 	std::vector<Tile> tiles;
 
+private:
+	// the frames each tile was last rendered to the terrain cache with
+	struct CachedTile {
+		Holder<Sprite2D> base;
+		Holder<Sprite2D> mask;
+		bool overlaid = false;
+
+		bool operator==(const CachedTile& other) const noexcept
+		{
+			return base == other.base && mask == other.mask && overlaid == other.overlaid;
+		}
+	};
+
+	// the viewport sized terrain from the last frame, so only the tiles that
+	// changed or scrolled into view need to be blitted again
+	VideoBufferPtr terrainCache;
+	VideoBufferPtr scrollBuffer;
+	Region cachedViewport;
+	BlitFlags cachedFlags = BlitFlags::NONE;
+	Color cachedTint;
+	std::vector<CachedTile> cachedTiles;
+	std::vector<Holder<Sprite2D>> overlayFrames;
+
+	void DrawTile(const Tile& tile, const CachedTile& frames, const Point& p, BlitFlags flags, const Color& tint, bool layeredWater) const;
+	bool ScrollCache(const Region& viewport);
+
 public:
 	using TileOverlayPtr = Holder<TileOverlay>;
 
@@ -45,7 +73,7 @@ public:
 	TileOverlay& operator=(TileOverlay&&) noexcept = default;
 
 	void AddTile(Tile&& tile);
-	void Draw(const Region& viewport, std::vector<TileOverlayPtr>& overlays, BlitFlags flags) const;
+	void Draw(const Region& viewport, std::vector<TileOverlayPtr>& overlays, BlitFlags flags);
 };
 
 }
@@ -24,6 +24,14 @@
 
 #include "Logging/Logging.h"
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define SPANS_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 namespace GemRB {
 
 IPixelIterator* PixelFormatIterator::InitImp(void* pixel, int pitch) const noexcept
@@ -252,4 +260,274 @@ const Point& PixelFormatIterator::Position() const noexcept
 	return imp->Position();
 }
 
+bool IsSpanFormat(const PixelFormat& fmt) noexcept
+{
+	if (fmt.Bpp != 4 || fmt.RLE) return false;
+	if (fmt.Rloss || fmt.Gloss || fmt.Bloss) return false;
+	if (fmt.Rmask != 0xffU << fmt.Rshift || fmt.Gmask != 0xffU << fmt.Gshift || fmt.Bmask != 0xffU << fmt.Bshift) {
+		return false;
+	}
+	if (fmt.Amask == 0) {
+		// the color key would make pixels transparent
+		return !fmt.HasColorKey;
+	}
+	return fmt.Aloss == 0 && fmt.Amask == 0xffU << fmt.Ashift;
+}
+
+namespace {
+
+struct SpanLayout {
+	uint8_t r;
+	uint8_t g;
+	uint8_t b;
+	uint8_t a;
+	bool hasAlpha;
+
+	explicit SpanLayout(const PixelFormat& fmt) noexcept
+		: r(fmt.Rshift), g(fmt.Gshift), b(fmt.Bshift), a(fmt.Ashift), hasAlpha(fmt.Amask != 0)
+	{}
+
+	Color Unpack(uint32_t px) const noexcept
+	{
+		return Color(px >> r, px >> g, px >> b, hasAlpha ? uint8_t(px >> a) : 255);
+	}
+
+	uint32_t Pack(const Color& c) const noexcept
+	{
+		uint32_t px = uint32_t(c.r) << r | uint32_t(c.g) << g | uint32_t(c.b) << b;
+		if (hasAlpha) px |= uint32_t(c.a) << a;
+		return px;
+	}
+};
+
+// the scalar version of RGBBlendingPipeline<SHADE, true>, also used for the leftovers
+uint32_t BlendPixel(uint32_t srcPx, uint32_t dstPx, uint8_t mask, const SpanLayout& sl, const SpanLayout& dl,
+		    SHADER shade, const Color& tint, unsigned int shift) noexcept
+{
+	// skipped pixels are still written back, dropping any unused bits
+	Color d = dl.Unpack(dstPx);
+	Color c = sl.Unpack(srcPx);
+	if (c.a == 0) return dl.Pack(d);
+
+	c.a = mask ? (255 - mask) + (c.a * mask) : c.a;
+	if (shade == SHADER::TINT || shade == SHADER::GREYSCALE || shade == SHADER::SEPIA) {
+		c.r = (tint.r * c.r) >> shift;
+		c.g = (tint.g * c.g) >> shift;
+		c.b = (tint.b * c.b) >> shift;
+	}
+	if (shade == SHADER::GREYSCALE) {
+		uint8_t avg = c.r + c.g + c.b;
+		c.r = c.g = c.b = avg;
+	} else if (shade == SHADER::SEPIA) {
+		uint8_t avg = c.r + c.g + c.b;
+		c.r = avg + 21;
+		c.g = avg;
+		c.b = avg < 32 ? 0 : avg - 32;
+	}
+
+	ShaderBlend<true>(c, d);
+	return dl.Pack(d);
+}
+
+uint32_t FillPixel(const Color& c, uint32_t dstPx, const SpanLayout& dl, SHADER shade) noexcept
+{
+	Color d = dl.Unpack(dstPx);
+	if (shade == SHADER::TINT) {
+		ShaderTint(c, d);
+	} else {
+		ShaderBlend<false>(c, d);
+	}
+	return dl.Pack(d);
+}
+
+#ifdef SPANS_SSE2
+// four pixels per step in 32 bit lanes, so the channel shifts can stay arbitrary;
+// all products fit into 16 bits, which is what _mm_mullo_epi16 keeps
+struct SSELayout {
+	__m128i r;
+	__m128i g;
+	__m128i b;
+	__m128i a;
+	bool hasAlpha;
+
+	explicit SSELayout(const SpanLayout& layout) noexcept
+		: r(_mm_cvtsi32_si128(layout.r)), g(_mm_cvtsi32_si128(layout.g)), b(_mm_cvtsi32_si128(layout.b)),
+		  a(_mm_cvtsi32_si128(layout.a)), hasAlpha(layout.hasAlpha)
+	{}
+};
+
+inline __m128i Channel(__m128i px, __m128i shift) noexcept
+{
+	return _mm_and_si128(_mm_srl_epi32(px, shift), _mm_set1_epi32(0xff));
+}
+
+inline __m128i Select(__m128i cond, __m128i yes, __m128i no) noexcept
+{
+	return _mm_or_si128(_mm_and_si128(cond, yes), _mm_andnot_si128(cond, no));
+}
+
+// same approximation as ShaderBlend
+inline __m128i Div255(__m128i x) noexcept
+{
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32(1)), _mm_srli_epi32(x, 8)), 8);
+}
+
+inline __m128i Mul(__m128i x, __m128i y) noexcept
+{
+	return _mm_mullo_epi16(x, y);
+}
+
+inline __m128i Pack(__m128i r, __m128i g, __m128i b, __m128i a, const SSELayout& layout) noexcept
+{
+	__m128i px = _mm_or_si128(_mm_sll_epi32(r, layout.r), _mm_or_si128(_mm_sll_epi32(g, layout.g), _mm_sll_epi32(b, layout.b)));
+	if (layout.hasAlpha) {
+		px = _mm_or_si128(px, _mm_sll_epi32(a, layout.a));
+	}
+	return px;
+}
+
+int BlendSpanSSE2(const uint32_t* src, const SpanLayout& sl, uint32_t* dst, const SpanLayout& dl,
+		  const uint8_t* mask, int count, SHADER shade, const Color& tint, unsigned int shift) noexcept
+{
+	const SSELayout ssl(sl);
+	const SSELayout sdl(dl);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ff = _mm_set1_epi32(0xff);
+	const __m128i tintR = _mm_set1_epi32(tint.r);
+	const __m128i tintG = _mm_set1_epi32(tint.g);
+	const __m128i tintB = _mm_set1_epi32(tint.b);
+	const __m128i tintShift = _mm_cvtsi32_si128(int(shift));
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+
+		__m128i dr = Channel(d, sdl.r);
+		__m128i dg = Channel(d, sdl.g);
+		__m128i db = Channel(d, sdl.b);
+		__m128i da = dl.hasAlpha ? Channel(d, sdl.a) : ff;
+		__m128i a = sl.hasAlpha ? Channel(s, ssl.a) : ff;
+		// skipped pixels are still written back, dropping any unused bits
+		__m128i skip = _mm_cmpeq_epi32(a, zero);
+		if (_mm_movemask_epi8(skip) == 0xffff) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Pack(dr, dg, db, da, sdl));
+			continue;
+		}
+
+		if (mask) {
+			int32_t m4;
+			memcpy(&m4, mask + i, sizeof(m4));
+			__m128i m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(m4), zero), zero);
+			__m128i masked = _mm_and_si128(_mm_add_epi32(_mm_sub_epi32(ff, m), Mul(a, m)), ff);
+			a = Select(_mm_cmpeq_epi32(m, zero), a, masked);
+		}
+
+		__m128i r = Channel(s, ssl.r);
+		__m128i g = Channel(s, ssl.g);
+		__m128i b = Channel(s, ssl.b);
+		if (shade == SHADER::TINT || shade == SHADER::GREYSCALE || shade == SHADER::SEPIA) {
+			r = _mm_and_si128(_mm_srl_epi32(Mul(r, tintR), tintShift), ff);
+			g = _mm_and_si128(_mm_srl_epi32(Mul(g, tintG), tintShift), ff);
+			b = _mm_and_si128(_mm_srl_epi32(Mul(b, tintB), tintShift), ff);
+		}
+		if (shade == SHADER::GREYSCALE || shade == SHADER::SEPIA) {
+			__m128i avg = _mm_and_si128(_mm_add_epi32(_mm_add_epi32(r, g), b), ff);
+			if (shade == SHADER::GREYSCALE) {
+				r = g = b = avg;
+			} else {
+				r = _mm_and_si128(_mm_add_epi32(avg, _mm_set1_epi32(21)), ff);
+				g = avg;
+				// negative lanes are negative in both 16 bit halves too
+				b = _mm_max_epi16(_mm_sub_epi32(avg, _mm_set1_epi32(32)), zero);
+			}
+		}
+
+		__m128i inv = _mm_sub_epi32(ff, a);
+		__m128i blended = Pack(_mm_and_si128(_mm_add_epi32(Div255(Mul(a, r)), Div255(Mul(inv, dr))), ff),
+				       _mm_and_si128(_mm_add_epi32(Div255(Mul(a, g)), Div255(Mul(inv, dg))), ff),
+				       _mm_and_si128(_mm_add_epi32(Div255(Mul(a, b)), Div255(Mul(inv, db))), ff),
+				       _mm_and_si128(_mm_add_epi32(a, Div255(Mul(inv, da))), ff), sdl);
+
+		__m128i out = Select(skip, Pack(dr, dg, db, da, sdl), blended);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+	}
+	return i;
+}
+
+int FillSpanSSE2(const Color& c, uint32_t* dst, const SpanLayout& dl, int count, SHADER shade) noexcept
+{
+	const SSELayout sdl(dl);
+	const __m128i ff = _mm_set1_epi32(0xff);
+	__m128i cr;
+	__m128i cg;
+	__m128i cb;
+	const __m128i inv = _mm_set1_epi32(255 - c.a);
+	if (shade == SHADER::TINT) {
+		cr = _mm_set1_epi32(c.r);
+		cg = _mm_set1_epi32(c.g);
+		cb = _mm_set1_epi32(c.b);
+	} else {
+		// the source half of the blend is the same for every pixel
+		cr = Div255(_mm_set1_epi32(c.a * c.r));
+		cg = Div255(_mm_set1_epi32(c.a * c.g));
+		cb = Div255(_mm_set1_epi32(c.a * c.b));
+	}
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+		__m128i dr = Channel(d, sdl.r);
+		__m128i dg = Channel(d, sdl.g);
+		__m128i db = Channel(d, sdl.b);
+		__m128i da = dl.hasAlpha ? Channel(d, sdl.a) : ff;
+		if (shade == SHADER::TINT) {
+			dr = _mm_srli_epi32(Mul(cr, dr), 8);
+			dg = _mm_srli_epi32(Mul(cg, dg), 8);
+			db = _mm_srli_epi32(Mul(cb, db), 8);
+		} else {
+			dr = _mm_and_si128(_mm_add_epi32(cr, Div255(Mul(inv, dr))), ff);
+			dg = _mm_and_si128(_mm_add_epi32(cg, Div255(Mul(inv, dg))), ff);
+			db = _mm_and_si128(_mm_add_epi32(cb, Div255(Mul(inv, db))), ff);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), Pack(dr, dg, db, da, sdl));
+	}
+	return i;
+}
+#endif
+
+}
+
+void BlendSpan(const uint32_t* src, const PixelFormat& srcFmt, uint32_t* dst, const PixelFormat& dstFmt,
+	       const uint8_t* mask, int count, SHADER shade, const Color& tint, unsigned int shift) noexcept
+{
+	const SpanLayout sl(srcFmt);
+	const SpanLayout dl(dstFmt);
+
+	int i = 0;
+#ifdef SPANS_SSE2
+	i = BlendSpanSSE2(src, sl, dst, dl, mask, count, shade, tint, shift);
+#endif
+	for (; i < count; ++i) {
+		dst[i] = BlendPixel(src[i], dst[i], mask ? mask[i] : 0, sl, dl, shade, tint, shift);
+	}
+}
+
+void FillSpan(const Color& c, uint32_t* dst, const PixelFormat& dstFmt, int count, SHADER shade) noexcept
+{
+	const SpanLayout dl(dstFmt);
+	if (shade != SHADER::TINT && shade != SHADER::BLEND) {
+		std::fill_n(dst, count, dl.Pack(c));
+		return;
+	}
+
+	int i = 0;
+#ifdef SPANS_SSE2
+	i = FillSpanSSE2(c, dst, dl, count, shade);
+#endif
+	for (; i < count; ++i) {
+		dst[i] = FillPixel(c, dst[i], dl, shade);
+	}
+}
+
 }
@@ -170,8 +170,11 @@ GEM_EXPORT bool Schedule(ieDword schedule, ieDword time);
 #define SCHEDULE_MASK(time) (1 << core->Time.GetHour(time - core->Time.hour_size / 2))
 
 using tick_t = unsigned long; // milliseconds
+// when nonzero, it replaces the wall clock (benchmark mode)
+GEM_EXPORT extern tick_t VirtualMilliseconds;
 inline tick_t GetMilliseconds()
 {
+	if (VirtualMilliseconds) return VirtualMilliseconds;
 	using namespace std::chrono;
 	return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
 }
@@ -91,6 +91,22 @@ bool p2DAImporter::Open(std::unique_ptr<DataStream> str)
 	}
 
 	assert(rows.size() < std::numeric_limits<index_t>::max());
+
+	for (index_t i = 0; i < colNames.size(); ++i) {
+		if (!colIndex.Contains(colNames[i])) {
+			colIndex.Set(colNames[i], i);
+		}
+	}
+	for (index_t i = 0; i < rowNames.size(); ++i) {
+		if (!rowIndex.Contains(rowNames[i])) {
+			rowIndex.Set(rowNames[i], i);
+		}
+	}
+	for (const auto& row : rows) {
+		maxColumns = std::max(maxColumns, static_cast<index_t>(row.size()));
+	}
+	defNumber.valid = valid_signednumber(defVal.c_str(), defNumber.value);
+
 	return true;
 }
 
@@ -134,24 +150,42 @@ const std::string& p2DAImporter::QueryDefault() const
 	return defVal;
 }
 
-p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
+const p2DAImporter::Number& p2DAImporter::GetNumber(index_t row, index_t column) const
 {
-	for (index_t index = 0; index < rowNames.size(); index++) {
-		if (StringCompKey(rowNames[index], key)) {
-			return index;
+	// anything outside the table is the default
+	if (rows.size() <= row || maxColumns <= column) {
+		return defNumber;
+	}
+
+	if (numbers.empty()) {
+		numbers.resize(maxColumns);
+	}
+	auto& parsed = numbers[column];
+	if (parsed.empty()) {
+		parsed.resize(rows.size());
+		for (index_t i = 0; i < rows.size(); ++i) {
+			Number& number = parsed[i];
+			number.valid = valid_signednumber(QueryField(i, column).c_str(), number.value);
 		}
 	}
-	return npos;
+	return parsed[row];
+}
+
+bool p2DAImporter::QueryNumber(index_t row, index_t column, long& value) const
+{
+	const Number& number = GetNumber(row, column);
+	value = number.value;
+	return number.valid;
+}
+
+p2DAImporter::index_t p2DAImporter::GetRowIndex(const key_t& key) const
+{
+	return rowIndex.Get(key, npos);
 }
 
 p2DAImporter::index_t p2DAImporter::GetColumnIndex(const key_t& key) const
 {
-	for (index_t index = 0; index < colNames.size(); index++) {
-		if (StringCompKey(colNames[index], key)) {
-			return index;
-		}
-	}
-	return npos;
+	return colIndex.Get(key, npos);
 }
 
 const static std::string blank;
@@ -175,9 +209,8 @@ p2DAImporter::index_t p2DAImporter::FindTableValue(index_t col, long val, index_
 {
 	index_t max = GetRowCount();
 	for (index_t row = start; row < max; row++) {
-		const std::string& ret = QueryField(row, col);
-		long Value;
-		if (valid_signednumber(ret.c_str(), Value) && (Value == val))
+		const Number& number = GetNumber(row, col);
+		if (number.valid && number.value == val)
 			return row;
 	}
 	return npos;
@@ -23,6 +23,8 @@
 
 #include "TableMgr.h"
 
+#include "Strings/StringMap.h"
+
 #include <vector>
 
 namespace GemRB {
@@ -32,10 +34,24 @@ private:
 	using cell_t = std::string;
 	using row_t = std::vector<cell_t>;
 
+	struct Number {
+		long value = 0;
+		bool valid = false;
+	};
+
 	std::vector<cell_t> colNames;
 	std::vector<cell_t> rowNames;
 	std::vector<row_t> rows;
 	std::string defVal;
+	// case insensitive, to the first row or column of that name
+	StringMap<index_t> colIndex;
+	StringMap<index_t> rowIndex;
+	index_t maxColumns = 0;
+	Number defNumber;
+	// numeric cells, parsed a column at a time on first use
+	mutable std::vector<std::vector<Number>> numbers;
+
+	const Number& GetNumber(index_t row, index_t column) const;
 
 public:
 	static index_t npos;
@@ -53,6 +69,8 @@ public:
 		if it cannot return a value, it returns the default */
 	const std::string& QueryField(index_t row, index_t column) const override;
 	const std::string& QueryDefault() const override;
+	bool QueryNumber(index_t row, index_t column, long& value) const override;
+	using TableMgr::QueryNumber;
 
 	index_t GetRowIndex(const key_t& string) const override;
 	index_t GetColumnIndex(const key_t& string) const override;
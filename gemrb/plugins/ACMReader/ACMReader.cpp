@@ -20,6 +20,8 @@
 
 #include "general.h"
 
+#include <algorithm>
+
 using namespace GemRB;
 
 bool ACMReader::Import(DataStream* str)
@@ -99,11 +101,14 @@ size_t ACMReader::read_samples(short* buffer, size_t count)
 			if (!make_new_samples())
 				break;
 		}
-		*buffer = (short) ((*values) >> levels);
-		values++;
-		buffer++;
-		res += 1;
-		samples_ready--;
+		size_t chunk = std::min<size_t>(count - res, samples_ready);
+		for (size_t i = 0; i < chunk; i++) {
+			buffer[i] = (short) (values[i] >> levels);
+		}
+		values += chunk;
+		buffer += chunk;
+		res += chunk;
+		samples_ready -= int(chunk);
 	}
 	return res;
 }
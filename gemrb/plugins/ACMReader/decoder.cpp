@@ -22,9 +22,15 @@
 
 #include <cstdlib>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define ACM_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 int CSubbandDecoder::init_decoder()
 {
-	int memory_size = (levels == 0) ? 0 : (3 * (block_size >> 1) - 2);
+	// two rows of state for each level: block_size for the first one, then halving
+	int memory_size = (levels == 0) ? 0 : (2 * block_size - 2);
 	if (memory_size) {
 		memory_buffer = (int*) calloc(memory_size, sizeof(int));
 		if (!memory_buffer)
@@ -32,161 +38,76 @@ int CSubbandDecoder::init_decoder()
 	}
 	return 1;
 }
+
+// Originally two transforms (sub_4d3fcc for the first level, sub_4d420c for the
+// rest) walking the block column by column. Both boil down to the same step
+// applied to consecutive row pairs, so we go row by row instead, which lets the
+// columns be handled in parallel.
 void CSubbandDecoder::decode_data(int* buffer, int blocks)
 {
 	if (!levels) {
 		return;
 	} // no levels - no work
 
-	int *buff_ptr = buffer, *mem_ptr = memory_buffer;
+	int* mem_ptr = memory_buffer;
 	int sb_size = block_size >> 1; // current subband size
 
 	blocks <<= 1;
-	sub_4d3fcc((short*) mem_ptr, buff_ptr, sb_size, blocks);
-	mem_ptr += sb_size;
+	for (int i = 0; i < blocks; i += 2) {
+		synthesize_rows(buffer + i * sb_size, buffer + (i + 1) * sb_size, mem_ptr, mem_ptr + sb_size, sb_size);
+	}
+	// the first level kept its state in shorts
+	for (int i = 0; i < 2 * sb_size; i++) {
+		mem_ptr[i] = (short) mem_ptr[i];
+	}
+	mem_ptr += sb_size << 1;
 
 	for (int i = 0; i < blocks; i++)
-		buff_ptr[i * sb_size]++;
+		buffer[i * sb_size]++;
 
 	sb_size >>= 1;
 	blocks <<= 1;
 
 	while (sb_size != 0) {
-		sub_4d420c(mem_ptr, buff_ptr, sb_size, blocks);
+		for (int i = 0; i < blocks; i += 2) {
+			synthesize_rows(buffer + i * sb_size, buffer + (i + 1) * sb_size, mem_ptr, mem_ptr + sb_size, sb_size);
+		}
 		mem_ptr += sb_size << 1;
 		sb_size >>= 1;
 		blocks <<= 1;
 	}
 }
-void CSubbandDecoder::sub_4d3fcc(short* memory, int* buffer, int sb_size,
-				 int blocks) const
+
+void CSubbandDecoder::synthesize_rows(int* row0, int* row1, int* state0, int* state1, int count)
 {
-	int row_0, row_1, row_2 = 0, row_3 = 0, db_0, db_1;
-	int sb_size_2 = sb_size * 2, sb_size_3 = sb_size * 3;
-	if (blocks == 2) {
-		for (int i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			buffer[0] = buffer[0] + memory[0] + 2 * memory[1];
-			buffer[sb_size] = 2 * row_0 - memory[1] - buffer[sb_size];
-			memory[0] = (short) row_0;
-			memory[1] = (short) row_1;
-
-			memory += 2;
-			buffer++;
-		}
-	} else if (blocks == 4) {
-		for (int i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			row_2 = buffer[sb_size_2];
-			row_3 = buffer[sb_size_3];
-
-			buffer[0] = memory[0] + 2 * memory[1] + row_0;
-			buffer[sb_size] = -memory[1] + 2 * row_0 - row_1;
-			buffer[sb_size_2] = row_0 + 2 * row_1 + row_2;
-			buffer[sb_size_3] = -row_1 + 2 * row_2 - row_3;
-
-			memory[0] = (short) row_2;
-			memory[1] = (short) row_3;
-
-			memory += 2;
-			buffer++;
-		}
-	} else {
-		for (int i = 0; i < sb_size; i++) {
-			int* buff_ptr = buffer;
-			if ((blocks >> 1) & 1) {
-				row_0 = buff_ptr[0];
-				row_1 = buff_ptr[sb_size];
-
-				buff_ptr[0] = memory[0] + 2 * memory[1] + row_0;
-				buff_ptr[sb_size] = -memory[1] + 2 * row_0 - row_1;
-				buff_ptr += sb_size_2;
-
-				db_0 = row_0;
-				db_1 = row_1;
-			} else {
-				db_0 = memory[0];
-				db_1 = memory[1];
-			}
-
-			for (int j = 0; j < blocks >> 2; j++) {
-				row_0 = buff_ptr[0];
-				buff_ptr[0] = db_0 + 2 * db_1 + row_0;
-				buff_ptr += sb_size;
-				row_1 = buff_ptr[0];
-				buff_ptr[0] = -db_1 + 2 * row_0 - row_1;
-				buff_ptr += sb_size;
-				row_2 = buff_ptr[0];
-				buff_ptr[0] = row_0 + 2 * row_1 + row_2;
-				buff_ptr += sb_size;
-				row_3 = buff_ptr[0];
-				buff_ptr[0] = -row_1 + 2 * row_2 -
-					row_3;
-				buff_ptr += sb_size;
-
-				db_0 = row_2;
-				db_1 = row_3;
-			}
-			memory[0] = (short) row_2;
-			memory[1] = (short) row_3;
-			memory += 2;
-			buffer++;
-		}
+	int i = 0;
+#ifdef ACM_SSE2
+	for (; i + 4 <= count; i += 4) {
+		__m128i r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+		__m128i r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+		__m128i s0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state0 + i));
+		__m128i s1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state1 + i));
+
+		__m128i out0 = _mm_add_epi32(_mm_add_epi32(s0, _mm_slli_epi32(s1, 1)), r0);
+		__m128i out1 = _mm_sub_epi32(_mm_sub_epi32(_mm_slli_epi32(r0, 1), s1), r1);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row0 + i), out0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row1 + i), out1);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state0 + i), r0);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(state1 + i), r1);
 	}
+#endif
+	synthesize_rows_scalar(row0 + i, row1 + i, state0 + i, state1 + i, count - i);
 }
-void CSubbandDecoder::sub_4d420c(int* memory, int* buffer, int sb_size,
-				 int blocks) const
+
+void CSubbandDecoder::synthesize_rows_scalar(int* row0, int* row1, int* state0, int* state1, int count)
 {
-	int row_0, row_1, row_2 = 0, row_3 = 0, db_0, db_1;
-	int sb_size_2 = sb_size * 2, sb_size_3 = sb_size * 3;
-	if (blocks == 4) {
-		for (int i = 0; i < sb_size; i++) {
-			row_0 = buffer[0];
-			row_1 = buffer[sb_size];
-			row_2 = buffer[sb_size_2];
-			row_3 = buffer[sb_size_3];
-
-			buffer[0] = memory[0] + 2 * memory[1] + row_0;
-			buffer[sb_size] = -memory[1] + 2 * row_0 - row_1;
-			buffer[sb_size_2] = row_0 + 2 * row_1 + row_2;
-			buffer[sb_size_3] = -row_1 + 2 * row_2 - row_3;
-
-			memory[0] = row_2;
-			memory[1] = row_3;
-
-			memory += 2;
-			buffer++;
-		}
-	} else {
-		for (int i = 0; i < sb_size; i++) {
-			int* buff_ptr = buffer;
-			db_0 = memory[0];
-			db_1 = memory[1];
-			for (int j = 0; j < blocks >> 2; j++) {
-				row_0 = buff_ptr[0];
-				buff_ptr[0] = db_0 + 2 * db_1 + row_0;
-				buff_ptr += sb_size;
-				row_1 = buff_ptr[0];
-				buff_ptr[0] = -db_1 + 2 * row_0 - row_1;
-				buff_ptr += sb_size;
-				row_2 = buff_ptr[0];
-				buff_ptr[0] = row_0 + 2 * row_1 + row_2;
-				buff_ptr += sb_size;
-				row_3 = buff_ptr[0];
-				buff_ptr[0] = -row_1 + 2 * row_2 -
-					row_3;
-				buff_ptr += sb_size;
-
-				db_0 = row_2;
-				db_1 = row_3;
-			}
-			memory[0] = row_2;
-			memory[1] = row_3;
-
-			memory += 2;
-			buffer++;
-		}
+	for (int i = 0; i < count; i++) {
+		int r0 = row0[i];
+		int r1 = row1[i];
+		row0[i] = state0[i] + 2 * state1[i] + r0;
+		row1[i] = 2 * r0 - state1[i] - r1;
+		state0[i] = r0;
+		state1[i] = r1;
 	}
 }
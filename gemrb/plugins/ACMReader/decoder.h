@@ -26,9 +26,8 @@
 class CSubbandDecoder {
 private:
 	int levels, block_size;
+	// per level the last row pair of the previous block, split into two rows
 	int* memory_buffer = nullptr;
-	void sub_4d3fcc(short* memory, int* buffer, int sb_size, int blocks) const;
-	void sub_4d420c(int* memory, int* buffer, int sb_size, int blocks) const;
 
 public:
 	explicit CSubbandDecoder(int lev_cnt)
@@ -44,6 +43,13 @@ public:
 
 	int init_decoder();
 	void decode_data(int* buffer, int blocks);
+
+	// one synthesis step over a pair of rows, every column is independent:
+	// row0 = state0 + 2 * state1 + row0, row1 = 2 * row0 - state1 - row1
+	// and the old rows become the new state
+	static void synthesize_rows(int* row0, int* row1, int* state0, int* state1, int count);
+	// plain version of the above, used as reference
+	static void synthesize_rows_scalar(int* row0, int* row1, int* state0, int* state1, int count);
 };
 
 #endif
@@ -80,6 +80,20 @@ const FillerProc Fillers[32] = {
 
 inline void CValueUnpacker::prepare_bits(int bits)
 {
+	if (bits <= avail_bits) {
+		return;
+	}
+	// common case: top up with whole bytes at once, so the next few requests
+	// are served without coming back here; nobody asks for more than 16 bits
+	if (buffer_bit_offset + 4 <= UNPACKER_BUFFER_SIZE) {
+		while (avail_bits <= 24) {
+			next_bits |= ((unsigned int) bits_buffer[buffer_bit_offset] << avail_bits);
+			buffer_bit_offset++;
+			avail_bits += 8;
+		}
+		return;
+	}
+
 	while (bits > avail_bits) {
 		unsigned char one_byte;
 		if (buffer_bit_offset == UNPACKER_BUFFER_SIZE) {
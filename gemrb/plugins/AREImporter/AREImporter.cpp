@@ -729,6 +729,10 @@ void AREImporter::GetInfoPoint(DataStream* str, int idx, Map* map) const
 			map->tileProps.PaintSearchMap(below, tmp | PathMapFlags::PASSABLE);
 		}
 	}
+	// the map already built its path clusters from the unpainted searchmap
+	SearchmapPoint min { ip->BBox.origin };
+	SearchmapPoint max { ip->BBox.Maximum() };
+	map->InvalidateSearchMap(Region(min.x, min.y, max.x - min.x + 1, max.y - min.y + 1));
 }
 
 void AREImporter::GetContainer(DataStream* str, int idx, Map* map)
@@ -27,16 +27,22 @@
 #include "Logging/Logging.h"
 #include "Streams/FileCache.h"
 #include "Streams/FileStream.h"
+#include "Streams/MemoryStream.h"
 #include "Streams/SlicedStream.h"
+#include "System/ThreadPool.h"
 #if defined(SUPPORTS_MEMSTREAM)
 	#include "Streams/MappedFileMemoryStream.h"
+	#include "Streams/MemoryViewStream.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 using namespace GemRB;
 
 BIFImporter::~BIFImporter(void)
 {
-	delete stream;
 	if (fentries) {
 		delete[] fentries;
 	}
@@ -45,6 +51,9 @@ BIFImporter::~BIFImporter(void)
 	}
 }
 
+// archives being decompressed right now, so prewarming several doesn't oversubscribe the cpu
+static std::atomic<unsigned int> activeDecompressions { 0 };
+
 DataStream* BIFImporter::DecompressBIFC(DataStream* compressed, const path_t& path)
 {
 	Log(MESSAGE, "BIFImporter", "Decompressing {} ...", compressed->filename);
@@ -59,21 +68,65 @@ DataStream* BIFImporter::DecompressBIFC(DataStream* compressed, const path_t& pa
 		Log(ERROR, "BIFImporter", "Cannot write {}.", path);
 		return NULL;
 	}
+
+	// every block is a separate zlib stream, so batches of them can be inflated in parallel
+	unsigned int active = ++activeDecompressions;
+	ThreadPool pool(std::max(1U, ThreadPool::HardwareThreads() / active));
+	const size_t batchSize = pool.Size() * 4;
+	std::vector<std::future<MemoryStream*>> batch;
+	batch.reserve(batchSize);
+
+	auto inflateBlock = [&comp](MemoryStream* source, ieDword declen) -> MemoryStream* {
+		auto block = new MemoryStream("", malloc(declen), declen);
+		bool ok = comp->Decompress(block, source, static_cast<unsigned int>(source->Size())) == GEM_OK;
+		delete source;
+		if (!ok || block->GetPos() != declen) {
+			delete block;
+			return nullptr;
+		}
+		return block;
+	};
+
 	size_t finalsize = 0;
-	int laststep = 0;
-	while (finalsize < unCompBifSize) {
-		ieDword complen, declen;
-		compressed->ReadDword(declen);
-		compressed->ReadDword(complen);
-		if (comp->Decompress(&out, compressed, complen) != GEM_OK) {
-			return NULL;
+	bool failed = false;
+	while (finalsize < unCompBifSize && !failed) {
+		for (size_t i = 0; i < batchSize && finalsize < unCompBifSize; ++i) {
+			ieDword complen, declen;
+			compressed->ReadDword(declen);
+			compressed->ReadDword(complen);
+			void* data = malloc(complen);
+			if (compressed->Read(data, complen) != strret_t(complen)) {
+				free(data);
+				failed = true;
+				break;
+			}
+			auto source = new MemoryStream("", data, complen);
+			batch.push_back(pool.Submit([&inflateBlock, source, declen]() { return inflateBlock(source, declen); }));
+			finalsize += declen;
 		}
-		finalsize = out.GetPos();
-		if ((int) (finalsize * (10.0 / unCompBifSize)) != laststep) {
-			laststep++;
+
+		// write out in order, so the result is the same as with sequential decompression
+		for (auto& result : batch) {
+			MemoryStream* block = result.get();
+			if (!block) {
+				failed = true;
+				continue;
+			}
+			if (!failed && out.Write(block->GetData(), block->Size()) != strret_t(block->Size())) {
+				failed = true;
+			}
+			delete block;
 		}
+		batch.clear();
 	}
+	--activeDecompressions;
+
 	out.Close(); // This is necessary, since windows won't open the file otherwise.
+	if (failed) {
+		Log(ERROR, "BIFImporter", "Failed to decompress {}.", compressed->filename);
+		UnlinkFile(path);
+		return NULL;
+	}
 #if defined(SUPPORTS_MEMSTREAM)
 	return new MappedFileMemoryStream { path };
 #else
@@ -94,7 +147,6 @@ DataStream* BIFImporter::DecompressBIF(DataStream* compressed, const path_t& /*p
 
 int BIFImporter::OpenArchive(const path_t& path)
 {
-	delete stream;
 	stream = nullptr;
 
 	path_t cachePath = PathJoin(core->config.CachePath, ExtractFileFromPath(path));
@@ -109,7 +161,7 @@ int BIFImporter::OpenArchive(const path_t& path)
 		if (!file->isOk()) {
 			delete file;
 #else
-	stream = FileStream::OpenFile(cachePath);
+	stream.reset(FileStream::OpenFile(cachePath));
 
 	if (!stream) {
 		FileStream* file = FileStream::OpenFile(path);
@@ -123,21 +175,21 @@ int BIFImporter::OpenArchive(const path_t& path)
 		}
 
 		if (strncmp(Signature, "BIF V1.0", 8) == 0) {
-			stream = DecompressBIF(file, cachePath.c_str());
+			stream.reset(DecompressBIF(file, cachePath.c_str()));
 			delete file;
 		} else if (strncmp(Signature, "BIFCV1.0", 8) == 0) {
-			stream = DecompressBIFC(file, cachePath.c_str());
+			stream.reset(DecompressBIFC(file, cachePath.c_str()));
 			delete file;
 		} else if (strncmp(Signature, "BIFFV1  ", 8) == 0) {
 			file->Seek(0, GEM_STREAM_START);
-			stream = file;
+			stream.reset(file);
 		} else {
 			delete file;
 			return GEM_ERROR;
 		}
 #if defined(SUPPORTS_MEMSTREAM)
 	} else {
-		stream = cacheStream;
+		stream.reset(cacheStream);
 #endif
 	}
 
@@ -153,22 +205,41 @@ int BIFImporter::OpenArchive(const path_t& path)
 	return ReadBIF();
 }
 
+DataStream* BIFImporter::SliceArchive(strpos_t offset, strpos_t size) const
+{
+	if (offset + size > stream->Size()) {
+		Log(ERROR, "BIFImporter", "Entry at {} ({} bytes) lies outside of {}.", offset, size, stream->filename);
+		return nullptr;
+	}
+
+#if defined(SUPPORTS_MEMSTREAM)
+	// the whole archive is mapped, so just hand out views into it: no copies, no reopening
+	auto mapping = std::static_pointer_cast<const MemoryStream>(stream);
+	return new MemoryViewStream(std::move(mapping), offset, size);
+#else
+	return SliceStream(stream.get(), offset, size);
+#endif
+}
+
 DataStream* BIFImporter::GetStream(unsigned long Resource, unsigned long Type)
 {
 	if (Type == IE_TIS_CLASS_ID) {
 		unsigned int srcResLoc = Resource & 0xFC000;
 		for (unsigned int i = 0; i < tentcount; i++) {
 			if ((tentries[i].resLocator & 0xFC000) == srcResLoc) {
-				return SliceStream(stream, tentries[i].dataOffset,
-						   tentries[i].tileSize * tentries[i].tilesCount);
+				return SliceArchive(tentries[i].dataOffset,
+						    tentries[i].tileSize * tentries[i].tilesCount);
 			}
 		}
 	} else {
 		ieDword srcResLoc = Resource & 0x3FFF;
+		// the file index is normally also the entry position, so try that first
+		if (srcResLoc < fentcount && (fentries[srcResLoc].resLocator & 0x3FFF) == srcResLoc) {
+			return SliceArchive(fentries[srcResLoc].dataOffset, fentries[srcResLoc].fileSize);
+		}
 		for (ieDword i = 0; i < fentcount; i++) {
 			if ((fentries[i].resLocator & 0x3FFF) == srcResLoc) {
-				return SliceStream(stream, fentries[i].dataOffset,
-						   fentries[i].fileSize);
+				return SliceArchive(fentries[i].dataOffset, fentries[i].fileSize);
 			}
 		}
 	}
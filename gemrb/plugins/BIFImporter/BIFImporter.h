@@ -24,6 +24,8 @@
 #include "Plugins/IndexedArchive.h"
 #include "Streams/DataStream.h"
 
+#include <memory>
+
 namespace GemRB {
 
 struct FileEntry {
@@ -49,7 +51,8 @@ private:
 	TileEntry* tentries = nullptr;
 	ieDword fentcount = 0;
 	ieDword tentcount = 0;
-	DataStream* stream = nullptr;
+	// with SUPPORTS_MEMSTREAM this is always the mapped (or cached and mapped) archive
+	std::shared_ptr<DataStream> stream;
 
 public:
 	BIFImporter() noexcept = default;
@@ -63,6 +66,7 @@ private:
 	static DataStream* DecompressBIF(DataStream* compressed, const path_t& path);
 	static DataStream* DecompressBIFC(DataStream* compressed, const path_t& path);
 	int ReadBIF();
+	DataStream* SliceArchive(strpos_t offset, strpos_t size) const;
 };
 
 }
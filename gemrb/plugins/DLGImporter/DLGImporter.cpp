@@ -159,6 +159,7 @@ Condition* DLGImporter::GetCondition(const char* string) const
 		free(lines[i]);
 	}
 	free(lines);
+	condition->ReorderTriggers();
 	return condition;
 }
 
@@ -43,6 +43,8 @@ public:
 	/** returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc& type) override;
+	/** we hit the filesystem every time, so new files are picked up (eg. the cache) */
+	bool IsVolatile() const override { return true; }
 };
 
 class CachedDirectoryImporter : public DirectoryImporter {
@@ -60,6 +62,7 @@ public:
 	/** returns resource */
 	DataStream* GetResource(StringView resname, SClass_ID type) override;
 	DataStream* GetResource(StringView resname, const ResourceDesc& type) override;
+	bool IsVolatile() const override { return false; }
 };
 
 
@@ -457,13 +457,13 @@ int fx_unknown(Scriptable* Owner, Actor* target, Effect* fx); //???
 
 static EffectDesc effectnames[] = {
 	EffectDesc("*Crash*", fx_crash, EFFECT_NO_ACTOR, -1),
-	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("AcidResistanceModifier", fx_acid_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("ACVsCreatureType", fx_generic_effect, 0, -1), //0xdb
-	EffectDesc("ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, 0, -1),
-	EffectDesc("ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, 0, -1), // used in IWD
+	EffectDesc("ACVsDamageTypeModifier", fx_ac_vs_damage_type_modifier, EFFECT_STAT_ONLY, -1),
+	EffectDesc("ACVsDamageTypeModifier2", fx_ac_vs_damage_type_modifier, EFFECT_STAT_ONLY, -1), // used in IWD
 	EffectDesc("AidNonCumulative", fx_set_aid_state, 0, -1),
 	EffectDesc("AIIdentifierModifier", fx_ids_modifier, 0, -1),
-	EffectDesc("AlchemyModifier", fx_alchemy_modifier, 0, -1),
+	EffectDesc("AlchemyModifier", fx_alchemy_modifier, EFFECT_STAT_ONLY, -1),
 	EffectDesc("Alignment:Change", fx_alignment_change, 0, -1),
 	EffectDesc("Alignment:Invert", fx_alignment_invert, 0, -1),
 	EffectDesc("AlterAnimation", fx_alter_animation, EFFECT_NO_ACTOR, -1),
@@ -518,7 +518,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("ChaosShieldModifier", fx_chaos_shield_modifier, 0, -1),
 	EffectDesc("CharismaModifier", fx_charisma_modifier, EFFECT_SPECIAL_UNDO, -1),
 	EffectDesc("CheckForBerserkModifier", fx_checkforberserk_modifier, 0, -1),
-	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("ColdResistanceModifier", fx_cold_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("Color:BriefRGB", fx_brief_rgb, 0, -1),
 	EffectDesc("Color:GlowRGB", fx_glow_rgb, 0, -1),
 	EffectDesc("Color:DarkenRGB", fx_darken_rgb, 0, -1),
@@ -532,7 +532,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("CreateContingency", fx_create_contingency, 0, -1),
 	EffectDesc("CriticalHitModifier", fx_critical_hit_modifier, 0, -1),
 	EffectDesc("CriticalMissModifier", fx_generic_effect, 0, -1),
-	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("CrushingResistanceModifier", fx_crushing_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("Cure:Berserk", fx_cure_berserk_state, 0, -1),
 	EffectDesc("Cure:Blind", fx_cure_blind_state, 0, -1),
 	EffectDesc("Cure:CasterHold", fx_unpause_caster, 0, -1),
@@ -590,7 +590,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("DrainItems", fx_drain_items, 0, -1),
 	EffectDesc("DrainSpells", fx_drain_spells, 0, -1),
 	EffectDesc("DropWeapon", fx_drop_weapon, 0, -1),
-	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("ElectricityResistanceModifier", fx_electricity_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("EnchantmentBonus", fx_generic_effect, 0, -1),
 	EffectDesc("EnchantmentVsCreatureType", fx_generic_effect, 0, -1),
 	EffectDesc("ExistanceDelayModifier", fx_existence_delay_modifier, 0, -1),
@@ -602,8 +602,8 @@ static EffectDesc effectnames[] = {
 	EffectDesc("FatigueModifier", fx_fatigue_modifier, EFFECT_SPECIAL_UNDO, -1),
 	EffectDesc("FindFamiliar", fx_find_familiar, 0, -1),
 	EffectDesc("FindTraps", fx_find_traps, 0, -1),
-	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("FindTrapsModifier", fx_find_traps_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("FireResistanceModifier", fx_fire_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("FistDamageModifier", fx_fist_damage_modifier, 0, -1),
 	EffectDesc("FistHitModifier", fx_fist_to_hit_modifier, 0, -1),
 	EffectDesc("FloatText", fx_floattext, 0, -1),
@@ -636,15 +636,15 @@ static EffectDesc effectnames[] = {
 	EffectDesc("KillCreatureType", fx_kill_creature_type, 0, -1),
 	EffectDesc("LevelModifier", fx_level_modifier, 0, -1),
 	EffectDesc("LevelDrainModifier", fx_leveldrain_modifier, 0, -1),
-	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK | EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("LoreModifier", fx_lore_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("LuckModifier", fx_luck_modifier, EFFECT_NO_LEVEL_CHECK | EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("LuckCumulative", fx_luck_cumulative, 0, -1),
 	EffectDesc("LuckNonCumulative", fx_luck_non_cumulative, 0, -1),
-	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("MagicalColdResistanceModifier", fx_magical_cold_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("MagicalFireResistanceModifier", fx_magical_fire_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("MagicalRest", fx_magical_rest, 0, -1),
-	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, 0, -1),
-	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, 0, -1),
+	EffectDesc("MagicDamageResistanceModifier", fx_magic_damage_resistance_modifier, EFFECT_STAT_ONLY, -1),
+	EffectDesc("MagicResistanceModifier", fx_magic_resistance_modifier, EFFECT_STAT_ONLY, -1),
 	EffectDesc("MakeUnselectable", fx_crash, 0, -1),
 	EffectDesc("MassRaiseDead", fx_mass_raise_dead, EFFECT_NO_ACTOR, -1),
 	EffectDesc("MaximumHPModifier", fx_maximum_hp_modifier, EFFECT_DICED | EFFECT_SPECIAL_UNDO, -1),
@@ -656,7 +656,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("MiscastMagicModifier", fx_miscast_magic_modifier, 0, -1),
 	EffectDesc("MissileDamageModifier", fx_missile_damage_modifier, 0, -1),
 	EffectDesc("MissileHitModifier", fx_missile_to_hit_modifier, 0, -1),
-	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("MissilesResistanceModifier", fx_missiles_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("MirrorImage", fx_mirror_image, 0, -1),
 	EffectDesc("MirrorImageModifier", fx_mirror_image_modifier, 0, -1),
 	EffectDesc("ModalStateCheck", fx_modal_movement_check, 0, -1),
@@ -674,7 +674,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("NPCBump", fx_npc_bump, 0, -1),
 	EffectDesc("OffscreenAIModifier", fx_offscreenai_modifier, 0, -1),
 	EffectDesc("OffhandHitModifier", fx_left_to_hit_modifier, 0, -1),
-	EffectDesc("OpenLocksModifier", fx_open_locks_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("OpenLocksModifier", fx_open_locks_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("Overlay:Entangle", fx_set_entangle_state, 0, -1),
 	EffectDesc("Overlay:Grease", fx_set_grease_state, 0, -1),
 	EffectDesc("Overlay:MinorGlobe", fx_set_minorglobe_state, 0, -1),
@@ -682,8 +682,8 @@ static EffectDesc effectnames[] = {
 	EffectDesc("Overlay:ShieldGlobe", fx_set_shieldglobe_state, 0, -1),
 	EffectDesc("Overlay:Web", fx_set_web_state, 0, -1),
 	EffectDesc("PauseTarget", fx_pause_target, 0, -1), //also known as casterhold
-	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("PickPocketsModifier", fx_pick_pockets_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("PiercingResistanceModifier", fx_piercing_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("PlayMovie", fx_play_movie, EFFECT_NO_ACTOR, -1),
 	EffectDesc("PlaySound", fx_playsound, EFFECT_NO_ACTOR, -1),
 	EffectDesc("PlayVisualEffect", fx_play_visual_effect, EFFECT_REINIT_ON_LOAD, -1),
@@ -735,12 +735,12 @@ static EffectDesc effectnames[] = {
 	EffectDesc("RetreatFrom2", fx_turn_undead, 0, -1),
 	EffectDesc("RightHitModifier", fx_right_to_hit_modifier, 0, -1),
 	EffectDesc("SaveBonus", fx_save_bonus, 0, -1),
-	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("SaveVsBreathModifier", fx_save_vs_breath_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("SaveVsDeathModifier", fx_save_vs_death_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("SaveVsPolyModifier", fx_save_vs_poly_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("SaveVsSchoolModifier", fx_generic_effect, 0, -1),
-	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO, -1),
-	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("SaveVsSpellsModifier", fx_save_vs_spell_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
+	EffectDesc("SaveVsWandsModifier", fx_save_vs_wands_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("ScreenShake", fx_screenshake, EFFECT_NO_ACTOR, -1),
 	EffectDesc("ScriptingState", fx_scripting_state, 0, -1),
 	EffectDesc("Sequencer:Activate", fx_activate_spell_sequencer, EFFECT_PRESET_TARGET, -1),
@@ -755,7 +755,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("SetTrapsModifier", fx_set_traps_modifier, 0, -1),
 	EffectDesc("SevenEyes", fx_seven_eyes, 0, -1),
 	EffectDesc("SexModifier", fx_sex_modifier, 0, -1),
-	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("SlashingResistanceModifier", fx_slashing_resistance_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("SlowPoison", fx_slow_poison, 0, -1),
 	EffectDesc("Sparkle", fx_sparkle, 0, -1),
 	EffectDesc("SpellDurationModifier", fx_spell_duration_modifier, 0, -1),
@@ -800,7 +800,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("State:Slowed", fx_set_slowed_state, 0, -1),
 	EffectDesc("State:Stun", fx_set_stun_state, 0, -1),
 	EffectDesc("StaticCharge", fx_static_charge, EFFECT_NO_LEVEL_CHECK, -1),
-	EffectDesc("StealthModifier", fx_stealth_modifier, 0, -1),
+	EffectDesc("StealthModifier", fx_stealth_modifier, EFFECT_STAT_ONLY, -1),
 	EffectDesc("StoneSkinModifier", fx_stoneskin_modifier, 0, -1),
 	EffectDesc("StoneSkin2Modifier", fx_golem_stoneskin_modifier, 0, -1),
 	EffectDesc("StrengthModifier", fx_strength_modifier, EFFECT_SPECIAL_UNDO, -1),
@@ -812,7 +812,7 @@ static EffectDesc effectnames[] = {
 	EffectDesc("TimelessState", fx_timeless_modifier, 0, -1),
 	EffectDesc("Timestop", fx_timestop, 0, -1),
 	EffectDesc("TitleModifier", fx_title_modifier, 0, -1),
-	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO, -1),
+	EffectDesc("ToHitModifier", fx_to_hit_modifier, EFFECT_SPECIAL_UNDO | EFFECT_STAT_ONLY, -1),
 	EffectDesc("ToHitBonusModifier", fx_to_hit_bonus_modifier, EFFECT_SPECIAL_UNDO, -1),
 	EffectDesc("ToHitVsCreature", fx_generic_effect, 0, -1),
 	EffectDesc("TrackingModifier", fx_tracking_modifier, EFFECT_SPECIAL_UNDO, -1),
@@ -89,6 +89,26 @@ static void FindBIF(BIFEntry* entry)
 	Log(ERROR, "KEYImporter", "Cannot find {}...", entry->name);
 }
 
+static PluginHolder<IndexedArchive> OpenBIF(const path_t& path)
+{
+	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
+	if (ai->OpenArchive(path) == GEM_ERROR) {
+		Log(ERROR, "KEYImporter", "Cannot open archive {}", path);
+		return nullptr;
+	}
+	return ai;
+}
+
+static bool IsCompressedBIF(const path_t& path)
+{
+	FileStream file;
+	char signature[8];
+	if (!file.Open(path) || file.Read(signature, 8) != 8) {
+		return false;
+	}
+	return strncmp(signature, "BIF V1.0", 8) == 0 || strncmp(signature, "BIFCV1.0", 8) == 0;
+}
+
 bool KEYImporter::Open(const path_t& resfile, std::string desc)
 {
 	description = std::move(desc);
@@ -177,12 +197,37 @@ bool KEYImporter::Open(const path_t& resfile, std::string desc)
 
 	Log(MESSAGE, "KEYImporter", "Resources Loaded...");
 	delete f;
+
+	if (core->config.PrewarmArchives) {
+		PrewarmArchives();
+	}
 	return true;
 }
 
+void KEYImporter::PrewarmArchives()
+{
+	prewarmPool = std::make_unique<ThreadPool>();
+	for (auto& bif : biffiles) {
+		if (!bif.found || bif.pending || !IsCompressedBIF(bif.path)) {
+			continue;
+		}
+
+		auto pending = std::make_shared<PendingArchive>();
+		bif.pending = pending;
+		path_t path = bif.path;
+		prewarmPool->Submit([pending, path]() {
+			if (!pending->claimed.exchange(true)) {
+				pending->promise.set_value(OpenBIF(path));
+			}
+		});
+	}
+	Log(MESSAGE, "KEYImporter", "Decompressing archives on {} threads...", prewarmPool->Size());
+}
+
 bool KEYImporter::HasResource(StringView resname, SClass_ID type)
 {
-	return resources.find({ ResRef(resname), type }) != resources.cend();
+	// mask like GetResource does, so both agree on synonyms
+	return resources.find({ ResRef(resname), type & 0xFFFF }) != resources.cend();
 }
 
 bool KEYImporter::HasResource(StringView resname, const ResourceDesc& type)
@@ -213,13 +258,23 @@ DataStream* KEYImporter::GetStream(const ResRef& resname, ieWord type)
 		return NULL;
 	}
 
-	PluginHolder<IndexedArchive> ai = MakePluginHolder<IndexedArchive>(IE_BIF_CLASS_ID);
-	if (ai->OpenArchive(biffiles[bifnum].path) == GEM_ERROR) {
-		Log(ERROR, "KEYImporter", "Cannot open archive {}", biffiles[bifnum].path);
-		return NULL;
+	std::lock_guard<std::mutex> lock(archiveLock);
+	BIFEntry& bif = biffiles[bifnum];
+	if (bif.pending) {
+		// only block on the worker if it already started on this archive
+		if (bif.pending->claimed.exchange(true)) {
+			bif.archive = bif.pending->result.get();
+		}
+		bif.pending = nullptr;
+	}
+	if (!bif.archive) {
+		bif.archive = OpenBIF(bif.path);
+		if (!bif.archive) {
+			return NULL;
+		}
 	}
 
-	DataStream* ret = ai->GetStream(ResLocator, type);
+	DataStream* ret = bif.archive->GetStream(ResLocator, type);
 	if (ret) {
 		ret->filename.Format("{}.{}", resname, TypeExt(type));
 		StringToLower(ret->filename);
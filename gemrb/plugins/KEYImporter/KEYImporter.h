@@ -25,8 +25,13 @@
 #include "ResourceSource.h"
 
 #include "Plugins/IndexedArchive.h"
+#include "System/ThreadPool.h"
 #include "System/VFS.h"
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -35,12 +40,23 @@ namespace GemRB {
 
 class DataStream;
 
+// a compressed archive queued for decompression on the prewarm pool
+// whoever claims it first (a worker or the main thread needing it) does the work
+struct PendingArchive {
+	std::atomic<bool> claimed { false };
+	std::promise<PluginHolder<IndexedArchive>> promise;
+	std::future<PluginHolder<IndexedArchive>> result = promise.get_future();
+};
+
 struct BIFEntry {
 	path_t name;
 	ieWord BIFLocator;
 	path_t path;
 	int cd;
 	bool found;
+	// opened lazily on first use and kept, so the archive index is only parsed (and mapped) once
+	PluginHolder<IndexedArchive> archive;
+	std::shared_ptr<PendingArchive> pending;
 };
 
 struct MapKey {
@@ -72,20 +88,18 @@ struct MapKeyHash {
 	}
 };
 
-struct KEYCache {
-	KEYCache() { bifnum = 0xffffffff; }
-
-	unsigned int bifnum;
-	PluginHolder<IndexedArchive> plugin;
-};
-
 class KEYImporter : public ResourceSource {
 private:
 	std::vector<BIFEntry> biffiles;
 	std::unordered_map<MapKey, ieDword, MapKeyHash> resources;
+	std::unique_ptr<ThreadPool> prewarmPool;
+	// resources are also requested from the audio threads
+	std::mutex archiveLock;
 
 	/** Gets the stream associated to a RESKey */
 	DataStream* GetStream(const ResRef&, ieWord type);
+	/** Queues all compressed archives for decompression into the cache */
+	void PrewarmArchives();
 
 public:
 	bool Open(const path_t& file, std::string desc) override;
@@ -32,6 +32,11 @@ Holder<SoundStreamSourceHandle> NullSound::CreateStreamable(const AudioPlaybackC
 	return MakeHolder<NullSoundStreamSourceHandle>();
 }
 
+Holder<SoundBufferHandle> NullSound::CreateBuffer(DecodedSound, const AudioPlaybackConfig&)
+{
+	return MakeHolder<NullSoundBufferHandle>();
+}
+
 Holder<SoundBufferHandle> NullSound::LoadSound(ResourceHolder<SoundMgr>, const AudioPlaybackConfig&)
 {
 	return MakeHolder<NullSoundBufferHandle>();
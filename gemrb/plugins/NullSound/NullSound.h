@@ -62,7 +62,9 @@ public:
 
 	Holder<SoundSourceHandle> CreatePlaybackSource(const AudioPlaybackConfig&, bool priority = false) override;
 	Holder<SoundStreamSourceHandle> CreateStreamable(const AudioPlaybackConfig&, size_t) override;
+	Holder<SoundBufferHandle> CreateBuffer(DecodedSound, const AudioPlaybackConfig&) override;
 	Holder<SoundBufferHandle> LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig&) override;
+	bool WantsSamples() const override { return false; }
 
 	const AudioPoint& GetListenerPosition() const override { return point; }
 	void SetListenerPosition(const AudioPoint& p) override { point = p; }
@@ -0,0 +1,56 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2025 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "NullVideo.h"
+
+#include <cstdlib>
+
+namespace GemRB {
+
+bool NullVideo::SetFullscreenMode(bool set)
+{
+	fullscreen = set;
+	return true;
+}
+
+Holder<Sprite2D> NullVideo::CreateSprite(const Region& rgn, void* pixels, const PixelFormat& fmt)
+{
+	// like the SDL drivers, callers without pixels expect a blank buffer to fill
+	if (!pixels) {
+		pixels = calloc(rgn.w * rgn.h, fmt.Bpp);
+	}
+	return MakeHolder<Sprite2D>(rgn, pixels, fmt, uint16_t(rgn.w * fmt.Bpp));
+}
+
+Holder<Sprite2D> NullVideo::GetScreenshot(Region r, const VideoBufferPtr&)
+{
+	// a black picture, so saved games still get their preview
+	int width = r.w ? r.w : screenSize.w;
+	int height = r.h ? r.h : screenSize.h;
+	return CreateSprite(Region(0, 0, width, height), nullptr, PixelFormat::ARGB32Bit());
+}
+
+}
+
+#include "plugindef.h"
+
+GEMRB_PLUGIN(0x4E0B1DE, "Null Video Driver")
+PLUGIN_DRIVER(NullVideo, "none")
+END_PLUGIN()
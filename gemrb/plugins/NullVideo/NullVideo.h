@@ -0,0 +1,82 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2025 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#ifndef NULLVIDEO_H
+#define NULLVIDEO_H
+
+#include "Video/Video.h"
+
+namespace GemRB {
+
+// a video driver without a display, for headless runs like benchmarks
+// sprites keep their pixels, so anything reading them back still works
+
+class NullVideoBuffer : public VideoBuffer {
+public:
+	using VideoBuffer::VideoBuffer;
+
+	void Clear(const Region&) override { /* null */ }
+	void CopyPixels(const Region&, const void*, const int* = nullptr, ...) override { /* null */ }
+	bool RenderOnDisplay(void*) const override { return true; }
+};
+
+class NullVideo : public Video {
+public:
+	int Init() override { return GEM_OK; }
+
+	void SetWindowTitle(const char*) override { /* null */ }
+	bool SetFullscreenMode(bool set) override;
+	bool ToggleGrabInput() override { return false; }
+	void CaptureMouse(bool) override { /* null */ }
+	int GetDisplayRefreshRate() const override { return 0; }
+	int GetVirtualRefreshCap() const override { return 0; }
+
+	void StartTextInput() override { /* null */ }
+	void StopTextInput() override { /* null */ }
+	bool InTextInput() override { return false; }
+	bool TouchInputEnabled() override { return false; }
+
+	Holder<Sprite2D> CreateSprite(const Region&, void* pixels, const PixelFormat&) override;
+	void BlitSprite(const Holder<Sprite2D>&, const Region&, Region, BlitFlags, Color) override { /* null */ }
+	void BlitGameSprite(const Holder<Sprite2D>&, const Point&, BlitFlags, Color) override { /* null */ }
+	void BlitVideoBuffer(const VideoBufferPtr&, const Point&, BlitFlags, Color) override { /* null */ }
+	Holder<Sprite2D> GetScreenshot(Region r, const VideoBufferPtr& buf = nullptr) override;
+	void SetGamma(int, int) override { /* null */ }
+
+private:
+	void Wait(uint32_t) override { /* null, there's nothing to pace */ }
+	VideoBuffer* NewVideoBuffer(const Region& rgn, BufferFormat) override { return new NullVideoBuffer(rgn); }
+	void SwapBuffers(VideoBuffers&) override { /* null */ }
+	int PollEvents() override { return GEM_OK; }
+	int CreateDriverDisplay(const char*, bool) override { return GEM_OK; }
+
+	void DrawRectImp(const Region&, const Color&, bool, BlitFlags) override { /* null */ }
+	void DrawPointImp(const BasePoint&, const Color&, BlitFlags) override { /* null */ }
+	void DrawPointsImp(const std::vector<BasePoint>&, const Color&, BlitFlags) override { /* null */ }
+	void DrawCircleImp(const Point&, uint16_t, const Color&, BlitFlags) override { /* null */ }
+	void DrawEllipseImp(const Region&, const Color&, BlitFlags) override { /* null */ }
+	void DrawPolygonImp(const Gem_Polygon*, const Point&, const Color&, bool, BlitFlags) override { /* null */ }
+	void DrawLineImp(const BasePoint&, const BasePoint&, const Color&, BlitFlags) override { /* null */ }
+	void DrawLinesImp(const std::vector<Point>&, const Color&, BlitFlags) override { /* null */ }
+};
+
+}
+
+#endif
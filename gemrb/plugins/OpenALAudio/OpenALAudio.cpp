@@ -519,11 +519,9 @@ Holder<SoundStreamSourceHandle> OpenALBackend::CreateStreamable(const AudioPlayb
 	return MakeHolder<OpenALSoundStreamHandle>(source, config.channelVolume);
 }
 
-Holder<SoundBufferHandle> OpenALBackend::LoadSound(
-	ResourceHolder<SoundMgr> resource,
-	const AudioPlaybackConfig& config)
+Holder<SoundBufferHandle> OpenALBackend::CreateBuffer(DecodedSound sound, const AudioPlaybackConfig& config)
 {
-	auto buffers = GetBuffers(resource, config.spatial);
+	auto buffers = GetBuffers(sound, config.spatial);
 	if (buffers.first == 0) {
 		return Holder<SoundBufferHandle>();
 	}
@@ -531,9 +529,9 @@ Holder<SoundBufferHandle> OpenALBackend::LoadSound(
 	return MakeHolder<OpenALBufferHandle>(buffers);
 }
 
-ALPair OpenALBackend::GetBuffers(ResourceHolder<SoundMgr> resource, bool spatial) const
+ALPair OpenALBackend::GetBuffers(const DecodedSound& sound, bool spatial) const
 {
-	auto channels = resource->GetChannels();
+	auto channels = sound.format.channels;
 	assert(channels <= 2);
 	bool spatialStereo = channels > 1 && spatial;
 
@@ -543,30 +541,20 @@ ALPair OpenALBackend::GetBuffers(ResourceHolder<SoundMgr> resource, bool spatial
 		return { 0, 0 };
 	}
 
-	auto sampleRate = resource->GetSampleRate();
-	auto numSamples = resource->GetNumSamples();
-	auto totalBytesPerChannel = numSamples * 2;
+	auto sampleRate = sound.format.sampleRate;
 
 	// Positional sound doesn't work for stereo in all known implementations
 	// so make two sources and play them in parallel: https://openal.org/pipermail/openal/2016-August/000527.html
 	if (spatialStereo) {
-		std::vector<char> channel1;
-		std::vector<char> channel2;
-		channel1.resize(totalBytesPerChannel);
-		channel2.resize(totalBytesPerChannel);
-		auto actualSamples = resource->ReadSamplesIntoChannels(channel1.data(), channel2.data(), numSamples);
+		std::vector<char> channel1 = sound.Channel(0);
+		std::vector<char> channel2 = sound.Channel(1);
 
 		auto format = GetFormatEnum(1, 16);
-		alBufferData(buffers[0], format, channel1.data(), actualSamples * 2, sampleRate);
-		alBufferData(buffers[1], format, channel2.data(), actualSamples * 2, sampleRate);
+		alBufferData(buffers[0], format, channel1.data(), channel1.size(), sampleRate);
+		alBufferData(buffers[1], format, channel2.data(), channel2.size(), sampleRate);
 	} else {
-		std::vector<short> memory;
-		memory.resize(totalBytesPerChannel / sizeof(short));
-
-		// multiply always with 2 because it is in 16 bits
-		auto count = resource->read_samples(memory.data(), numSamples) * 2;
-		// it is always reading the stuff into 16 bits
-		alBufferData(buffers[0], GetFormatEnum(channels, 16), memory.data(), count, sampleRate);
+		// the samples are always 16 bit
+		alBufferData(buffers[0], GetFormatEnum(channels, 16), sound.samples.data(), sound.samples.size(), sampleRate);
 	}
 
 	if (CheckALError("Unable to fill buffer", ERROR)) {
@@ -106,7 +106,7 @@ public:
 
 	Holder<SoundSourceHandle> CreatePlaybackSource(const AudioPlaybackConfig& config, bool priority = false) override;
 	Holder<SoundStreamSourceHandle> CreateStreamable(const AudioPlaybackConfig& config, size_t) override;
-	Holder<SoundBufferHandle> LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig& config) override;
+	Holder<SoundBufferHandle> CreateBuffer(DecodedSound sound, const AudioPlaybackConfig& config) override;
 
 	const AudioPoint& GetListenerPosition() const override;
 	void SetListenerPosition(const AudioPoint& p) override;
@@ -119,7 +119,7 @@ private:
 	AudioPoint listenerPosition;
 
 	void InitEFX();
-	ALPair GetBuffers(ResourceHolder<SoundMgr> resource, bool spatial) const;
+	ALPair GetBuffers(const DecodedSound& sound, bool spatial) const;
 };
 }
 
@@ -364,17 +364,15 @@ Holder<SoundStreamSourceHandle> SDLAudioBackend::CreateStreamable(const AudioPla
 	return MakeHolder<SDLSoundStreamSourceHandle>(audioChannels * minQueueSize);
 }
 
-Holder<SoundBufferHandle> SDLAudioBackend::LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig&)
+Holder<SoundBufferHandle> SDLAudioBackend::CreateBuffer(DecodedSound sound, const AudioPlaybackConfig&)
 {
 	Mix_Chunk* chunk = nullptr;
 
-	auto numSamples = resource->GetNumSamples();
-	auto riffChans = resource->GetChannels();
-	auto sampleRate = resource->GetSampleRate();
+	auto riffChans = sound.format.channels;
+	auto sampleRate = sound.format.sampleRate;
 
-	std::vector<char> buffer {};
-	buffer.resize(numSamples * 2);
-	auto actualSamples = resource->read_samples(reinterpret_cast<short*>(buffer.data()), numSamples);
+	std::vector<char> buffer = std::move(sound.samples);
+	auto actualSamples = buffer.size() / 2;
 	if (actualSamples == 0) {
 		return {};
 	}
@@ -119,7 +119,7 @@ public:
 
 	Holder<SoundSourceHandle> CreatePlaybackSource(const AudioPlaybackConfig&, bool priority = false) override;
 	Holder<SoundStreamSourceHandle> CreateStreamable(const AudioPlaybackConfig&, size_t minQueueSize) override;
-	Holder<SoundBufferHandle> LoadSound(ResourceHolder<SoundMgr> resource, const AudioPlaybackConfig&) override;
+	Holder<SoundBufferHandle> CreateBuffer(DecodedSound sound, const AudioPlaybackConfig&) override;
 
 	const AudioPoint& GetListenerPosition() const override;
 	void SetListenerPosition(const AudioPoint& p) override;
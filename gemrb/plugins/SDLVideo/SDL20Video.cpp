@@ -94,8 +94,10 @@ SDL20VideoDriver::~SDL20VideoDriver() noexcept
 
 	// we must release all buffers before SDL_DestroyRenderer
 	// we cant rely on the base destructor here
+	if (renderBatch) renderBatch->Flush();
 	scratchBuffer = nullptr;
 	DestroyBuffers();
+	spriteAtlas = nullptr;
 
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
@@ -206,6 +208,13 @@ int SDL20VideoDriver::CreateSDLDisplay(const char* title, bool vsync)
 		return GEM_ERROR;
 	}
 
+	// 16 pages of 4MB each, smaller if the renderer can't handle them
+	int atlasPageSize = 1024;
+	if (info.max_texture_width > 0) atlasPageSize = std::min(atlasPageSize, info.max_texture_width);
+	if (info.max_texture_height > 0) atlasPageSize = std::min(atlasPageSize, info.max_texture_height);
+	spriteAtlas = std::make_shared<SDLTextureAtlas>(renderer, atlasPageSize, 16);
+	renderBatch = std::make_shared<SDLRenderBatch>(renderer, sdl2_runtime_version >= SDL_VERSIONNUM(2, 0, 18));
+
 #if USE_OPENGL_BACKEND
 	// glGetString can return null, fmt doesn't support const unsigned char* and std::string can handle neither
 	std::string tmp[4] = { "/" };
@@ -300,11 +309,13 @@ VideoBuffer* SDL20VideoDriver::NewVideoBuffer(const Region& r, BufferFormat fmt)
 		Log(ERROR, "SDL 2", "{}", SDL_GetError());
 		return nullptr;
 	}
-	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer);
+	return new SDLTextureVideoBuffer(r.origin, tex, fmt, renderer, renderBatch);
 }
 
 void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 {
+	renderBatch->Flush();
+
 #if USE_OPENGL_BACKEND
 	// we have coopted SDLs shader, so we need to reset uniforms to values appropriate for the render targets
 	blitRGBAShader->SetUniformValue("u_greyMode", 1, 0);
@@ -333,6 +344,8 @@ void SDL20VideoDriver::SwapBuffers(VideoBuffers& buffers)
 	TRACY(TracyGpuCollect);
 #endif
 
+	spriteAtlas->NextFrame();
+
 	TRACY(FrameMark);
 }
 
@@ -358,6 +371,7 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 {
 	// TODO: add support for BlitFlags::HALFTRANS, BlitFlags::COLOR_MOD, and others (no use for them ATM)
 
+	renderBatch->Flush();
 	SDL_Texture* target = CurrentRenderBuffer();
 
 	assert(target);
@@ -393,11 +407,17 @@ int SDL20VideoDriver::UpdateRenderTarget(const Color* color, BlitFlags flags)
 void SDL20VideoDriver::BlitSpriteNativeClipped(const SDLTextureSprite2D* spr, const Region& src, const Region& dst, BlitFlags flags, const SDL_Color* tint)
 {
 	flags &= ~spr->PrepareForRendering(flags, reinterpret_cast<const Color*>(tint));
-	SDL_Texture* tex = spr->GetTexture(renderer);
-	BlitSpriteNativeClipped(tex, src, dst, flags, tint);
+	if (spr->NeedsUpload()) {
+		// queued blits may still use the old pixels
+		renderBatch->Flush();
+	}
+	Point offset;
+	SDL_Texture* tex = spr->GetTexture(renderer, spriteAtlas, offset);
+	// sprites can destroy their own textures any time, but atlas pages stay around
+	BlitSpriteNativeClipped(tex, Region(src.origin + offset, src.size), dst, flags, tint, spr->InAtlas());
 }
 
-void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Region& srgn, const Region& drgn, BlitFlags flags, const SDL_Color* tint)
+void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Region& srgn, const Region& drgn, BlitFlags flags, const SDL_Color* tint, bool batchable)
 {
 	TRACY(ZoneScoped);
 	SDL_Rect srect = RectFromRegion(srgn);
@@ -405,6 +425,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 
 	int ret = 0;
 #if USE_OPENGL_BACKEND
+	(void) batchable;
 	UpdateRenderTarget();
 	ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
 	#if SDL_VERSION_ATLEAST(2, 0, 10)
@@ -417,6 +438,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		// 3. blend texture to scratchpad
 		// 4. copy scratchpad segment to screen
 
+		renderBatch->Flush();
 		std::static_pointer_cast<SDLTextureVideoBuffer>(scratchBuffer)->Clear(drect); // sets the render target to the scratch buffer
 
 		SDL_Texture* stencilTex = CurrentStencilBuffer();
@@ -442,7 +464,7 @@ void SDL20VideoDriver::BlitSpriteNativeClipped(SDL_Texture* texSprite, const Reg
 		SDL_SetRenderTarget(renderer, CurrentRenderBuffer());
 		SetTextureBlendMode(ScratchBuffer(), flags);
 		ret = SDL_RenderCopy(renderer, ScratchBuffer(), &drect, &drect);
-	} else {
+	} else if (!batchable || !QueueBlit(texSprite, srect, drect, flags, tint)) {
 		UpdateRenderTarget();
 		ret = RenderCopyShaded(texSprite, &srect, &drect, flags, tint);
 	}
@@ -461,7 +483,7 @@ void SDL20VideoDriver::BlitVideoBuffer(const VideoBufferPtr& buf, const Point& p
 
 	const Region& srect = { 0, 0, r.w, r.h };
 	const Region& drect = { origin, r.size };
-	BlitSpriteNativeClipped(tex, srect, drect, flags, reinterpret_cast<const SDL_Color*>(&tint));
+	BlitSpriteNativeClipped(tex, srect, drect, flags, reinterpret_cast<const SDL_Color*>(&tint), true);
 }
 
 int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* srcrect,
@@ -569,29 +591,56 @@ int SDL20VideoDriver::RenderCopyShaded(SDL_Texture* texture, const SDL_Rect* src
 	}
 #endif
 
-	Uint8 alpha = SDL_ALPHA_OPAQUE;
+	SDL_Color mod = ModulationColor(flags, tint);
+	SDL_SetTextureAlphaMod(texture, mod.a);
+	SDL_SetTextureColorMod(texture, mod.r, mod.g, mod.b);
+
+	SetTextureBlendMode(texture, flags);
+
+	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, FlipFlags(flags));
+}
+
+bool SDL20VideoDriver::QueueBlit(SDL_Texture* texture, const SDL_Rect& srect, const SDL_Rect& drect, BlitFlags flags, const SDL_Color* tint)
+{
+	if (!renderBatch->Enabled()) return false;
+
+	SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+	SetTextureBlendMode(texture, flags);
+	SDL_GetTextureBlendMode(texture, &blendMode);
+
+	// same as in UpdateRenderTarget
+	const SDL_Rect* clip = nullptr;
+	SDL_Rect clipRect = RectFromRegion(screenClip);
+	if (screenClip.size != screenSize) {
+		clip = &clipRect;
+	}
+
+	return renderBatch->AddQuad(CurrentRenderBuffer(), clip, texture, blendMode, srect, drect, ModulationColor(flags, tint), FlipFlags(flags));
+}
+
+SDL_Color SDL20VideoDriver::ModulationColor(BlitFlags flags, const SDL_Color* tint)
+{
+	SDL_Color mod = { 0xff, 0xff, 0xff, SDL_ALPHA_OPAQUE };
 	if (flags & BlitFlags::ALPHA_MOD) {
-		alpha = tint->a;
+		mod.a = tint->a;
 	}
 
 	if (flags & BlitFlags::HALFTRANS) {
-		alpha /= 2;
+		mod.a /= 2;
 	}
 
-	SDL_SetTextureAlphaMod(texture, alpha);
-
 	if (flags & BlitFlags::COLOR_MOD) {
-		SDL_SetTextureColorMod(texture, tint->r, tint->g, tint->b);
-	} else {
-		SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
+		mod.r = tint->r;
+		mod.g = tint->g;
+		mod.b = tint->b;
 	}
+	return mod;
+}
 
-	SetTextureBlendMode(texture, flags);
-
+SDL_RendererFlip SDL20VideoDriver::FlipFlags(BlitFlags flags)
+{
 	SDL_RendererFlip flipflags = (flags & BlitFlags::MIRRORY) ? SDL_FLIP_VERTICAL : SDL_FLIP_NONE;
-	flipflags = static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
-
-	return SDL_RenderCopyEx(renderer, texture, srcrect, dstrect, 0.0, nullptr, flipflags);
+	return static_cast<SDL_RendererFlip>(flipflags | ((flags & BlitFlags::MIRRORX) ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE));
 }
 
 void SDL20VideoDriver::SetTextureBlendMode(SDL_Texture* texture, BlitFlags flags) const
@@ -623,6 +672,9 @@ void SDL20VideoDriver::DrawRawGeometry(
 	BlitFlags blitFlags)
 {
 #if SDL_VERSION_ATLEAST(2, 0, 18)
+	// draws on whatever target the last blit left behind
+	renderBatch->Flush();
+
 	if (blitFlags & BlitFlags::BLENDED) {
 		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
 	}
@@ -743,6 +795,7 @@ Holder<Sprite2D> SDL20VideoDriver::GetScreenshot(Region r, const VideoBufferPtr&
 	static const PixelFormat fmt(3, 0x00ff0000, 0x0000ff00, 0x000000ff, 0);
 	SDLTextureSprite2D* screenshot = new SDLTextureSprite2D(Region(0, 0, Width, Height), fmt);
 
+	renderBatch->Flush();
 	SDL_Texture* target = SDL_GetRenderTarget(renderer);
 	if (buf) {
 		auto texture = static_cast<SDLTextureVideoBuffer*>(buf.get())->GetTexture();
@@ -904,6 +957,9 @@ int SDL20VideoDriver::ProcessEvent(const SDL_Event& event)
 		// TODO: these events will be sent by the D3D renderer and we will need to handle them
 		case SDL_RENDER_DEVICE_RESET:
 			// TODO: must destroy all SDLTextureSprite2D textures
+			// the atlas pages are easy, sprites notice the new pages and upload again
+			if (renderBatch) renderBatch->Flush();
+			if (spriteAtlas) spriteAtlas->Reset();
 
 			// fallthrough
 		case SDL_APP_DIDENTERFOREGROUND:
@@ -22,6 +22,7 @@
 #define SDL20VideoDRIVER_H
 
 
+#include "SDLRenderBatch.h"
 #include "SDLSurfaceDrawing.h"
 #include "SDLVideo.h"
 
@@ -68,6 +69,8 @@ Uint32 SDLPixelFormatFromBufferFormat(Video::BufferFormat fmt, SDL_Renderer* ren
 class SDLTextureVideoBuffer : public VideoBuffer {
 	SDL_Texture* texture;
 	SDL_Renderer* renderer;
+	// queued blits may read from or draw to our texture
+	std::shared_ptr<SDLRenderBatch> batch;
 
 	// the format of the pixel data the client thinks we use, we may have to convert in CopyPixels()
 	Uint32 inputFormat; // the SDL pixel format equivalent of the requested Video::BufferFormat
@@ -87,11 +90,12 @@ private:
 	}
 
 public:
-	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL_Renderer* renderer)
-		: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL))
+	SDLTextureVideoBuffer(const Point& p, SDL_Texture* texture, Video::BufferFormat fmt, SDL_Renderer* renderer, std::shared_ptr<SDLRenderBatch> batch)
+		: VideoBuffer(TextureRegion(texture, p)), texture(texture), renderer(renderer), batch(std::move(batch)), inputFormat(SDLPixelFormatFromBufferFormat(fmt, NULL))
 	{
 		assert(texture);
 		assert(renderer);
+		assert(this->batch);
 
 		int access;
 		SDL_QueryTexture(texture, &nativeFormat, &access, NULL, NULL);
@@ -105,12 +109,14 @@ public:
 
 	~SDLTextureVideoBuffer() override
 	{
+		batch->Flush();
 		SDL_DestroyTexture(texture);
 		SDL_FreeSurface(conversionBuffer);
 	}
 
 	void Clear() override
 	{
+		batch->Flush();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 #if SDL_COMPILEDVERSION == SDL_VERSIONNUM(2, 0, 10)
@@ -126,6 +132,7 @@ public:
 
 	void Clear(const SDL_Rect& rgn)
 	{
+		batch->Flush();
 		SDL_SetRenderTarget(renderer, texture);
 		SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
 		SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
@@ -151,6 +158,7 @@ public:
 
 	void CopyPixels(const Region& bufDest, const void* pixelBuf, const int* pitch = NULL, ...) override
 	{
+		batch->Flush();
 		int sdlpitch = bufDest.w * SDL_BYTESPERPIXEL(nativeFormat);
 		SDL_Rect dest = RectFromRegion(bufDest);
 
@@ -224,6 +232,8 @@ private:
 	SDL_Window* window;
 	SDL_Renderer* renderer;
 	int sdl2_runtime_version;
+	std::shared_ptr<SDLTextureAtlas> spriteAtlas;
+	std::shared_ptr<SDLRenderBatch> renderBatch;
 
 	SDL_BlendMode stencilAlphaBlender;
 	SDL_BlendMode oneMinusDstBlender;
@@ -295,9 +305,12 @@ private:
 				  BlitFlags /*flags*/ = BlitFlags::NONE, const Color* /*tint*/ = NULL) override { assert(false); } // SDL2 does not support this
 	void BlitSpriteNativeClipped(const sprite_t* spr, const Region& src, const Region& dst,
 				     BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL) override;
-	void BlitSpriteNativeClipped(SDL_Texture* spr, const Region& src, const Region& dst, BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL);
+	void BlitSpriteNativeClipped(SDL_Texture* spr, const Region& src, const Region& dst, BlitFlags flags = BlitFlags::NONE, const SDL_Color* tint = NULL, bool batchable = false);
 
 	int RenderCopyShaded(SDL_Texture*, const SDL_Rect* srcrect, const SDL_Rect* dstrect, BlitFlags flags, const SDL_Color* = nullptr);
+	bool QueueBlit(SDL_Texture*, const SDL_Rect& srcrect, const SDL_Rect& dstrect, BlitFlags flags, const SDL_Color* tint);
+	static SDL_Color ModulationColor(BlitFlags flags, const SDL_Color* tint);
+	static SDL_RendererFlip FlipFlags(BlitFlags flags);
 	void SetTextureBlendMode(SDL_Texture* texture, BlitFlags flags) const;
 
 	int GetTouchFingers(TouchEvent::Finger (&fingers)[FINGER_MAX], SDL_TouchID device) const;
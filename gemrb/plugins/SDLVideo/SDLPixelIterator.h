@@ -23,6 +23,8 @@
 
 #include "Video/Pixels.h"
 
+#include <vector>
+
 namespace GemRB {
 
 using SDLPixelIterator = PixelFormatIterator;
@@ -89,21 +91,6 @@ inline SDLPixelIteratorWrapper MakeSDLPixelIterator(SDL_Surface* surf, const Reg
 	return SDLPixelIteratorWrapper(surf, IPixelIterator::Direction::Forward, IPixelIterator::Direction::Forward, clip);
 }
 
-template<class BLENDER>
-static void ColorFill(const Color& c,
-		      SDLPixelIterator dst, const SDLPixelIterator& dstend,
-		      const BLENDER& blender)
-{
-	for (; dst != dstend; ++dst) {
-		Color dstc;
-		dst.ReadRGBA(dstc.r, dstc.g, dstc.b, dstc.a);
-
-		blender(c, dstc, 0);
-
-		dst.WriteRGBA(dstc.r, dstc.g, dstc.b, dstc.a);
-	}
-}
-
 template<class BLENDER>
 static void Blit(SDLPixelIterator src,
 		 SDLPixelIterator dst, const SDLPixelIterator& dstend,
@@ -135,6 +122,35 @@ static void BlitBlendedRect(SDLPixelIterator& src, SDLPixelIterator& dst,
 	}
 }
 
+template<SHADER SHADE>
+static void BlitBlendedRect(SDLPixelIterator& src, SDLPixelIterator& dst,
+			    const RGBBlendingPipeline<SHADE, true>& blender, IAlphaIterator* maskIt)
+{
+	if (!blender.HasSpanKernel() || !SpanIterable(src) || !SpanIterable(dst) || src.clip.size != dst.clip.size) {
+		BlitBlendedRect<const RGBBlendingPipeline<SHADE, true>&>(src, dst, blender, maskIt);
+		return;
+	}
+
+	int width = dst.clip.w;
+	// the stencil is walked in the same order as the generic loop would
+	std::vector<uint8_t> maskRow(maskIt ? width : 0);
+	uint8_t* srcRow = &*src;
+	uint8_t* dstRow = &*dst;
+	for (int y = 0; y < dst.clip.h; ++y) {
+		if (maskIt) {
+			for (auto& m : maskRow) {
+				m = **maskIt;
+				++*maskIt;
+			}
+		}
+		blender.BlendRow(reinterpret_cast<const uint32_t*>(srcRow), src.format,
+				 reinterpret_cast<uint32_t*>(dstRow), dst.format,
+				 maskIt ? maskRow.data() : nullptr, width);
+		srcRow += src.pitch * src.ydir;
+		dstRow += dst.pitch * dst.ydir;
+	}
+}
+
 }
 
 #endif // SDL_PIXEL_ITERATOR_H
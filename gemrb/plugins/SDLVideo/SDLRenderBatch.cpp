@@ -0,0 +1,119 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLRenderBatch.h"
+
+#include "Logging/Logging.h"
+
+namespace GemRB {
+
+SDLRenderBatch::SDLRenderBatch(SDL_Renderer* renderer, bool enabled) noexcept
+	: renderer(renderer)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	this->enabled = enabled;
+#else
+	(void) enabled;
+#endif
+}
+
+bool SDLRenderBatch::AddQuad(SDL_Texture* tgt, const SDL_Rect* clp, SDL_Texture* tex, SDL_BlendMode blend,
+			     const SDL_Rect& src, const SDL_Rect& dst, const SDL_Color& mod, SDL_RendererFlip flip)
+{
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (!enabled) return false;
+
+	bool sameClip = clp ? (clipped && SDL_RectEquals(clp, &clip)) : !clipped;
+	if (tex != texture || tgt != target || blend != blendMode || !sameClip) {
+		Flush();
+
+		int w = 0;
+		int h = 0;
+		if (SDL_QueryTexture(tex, nullptr, nullptr, &w, &h) != 0) {
+			return false;
+		}
+		target = tgt;
+		texture = tex;
+		blendMode = blend;
+		clipped = clp != nullptr;
+		if (clp) clip = *clp;
+		texW = float(w);
+		texH = float(h);
+	}
+
+	float u1 = src.x / texW;
+	float v1 = src.y / texH;
+	float u2 = (src.x + src.w) / texW;
+	float v2 = (src.y + src.h) / texH;
+	if (flip & SDL_FLIP_HORIZONTAL) std::swap(u1, u2);
+	if (flip & SDL_FLIP_VERTICAL) std::swap(v1, v2);
+
+	float x1 = float(dst.x);
+	float y1 = float(dst.y);
+	float x2 = float(dst.x + dst.w);
+	float y2 = float(dst.y + dst.h);
+
+	int base = int(vertices.size());
+	vertices.push_back({ { x1, y1 }, mod, { u1, v1 } });
+	vertices.push_back({ { x2, y1 }, mod, { u2, v1 } });
+	vertices.push_back({ { x2, y2 }, mod, { u2, v2 } });
+	vertices.push_back({ { x1, y2 }, mod, { u1, v2 } });
+	for (int i : { 0, 1, 2, 0, 2, 3 }) {
+		indices.push_back(base + i);
+	}
+	return true;
+#else
+	(void) tgt;
+	(void) clp;
+	(void) tex;
+	(void) blend;
+	(void) src;
+	(void) dst;
+	(void) mod;
+	(void) flip;
+	return false;
+#endif
+}
+
+int SDLRenderBatch::Flush()
+{
+	int ret = 0;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	if (vertices.empty()) return ret;
+
+	SDL_SetRenderTarget(renderer, target);
+	SDL_RenderSetClipRect(renderer, clipped ? &clip : nullptr);
+	// the modulation is in the vertex colors, make sure it doesn't get applied twice
+	SDL_SetTextureColorMod(texture, 0xff, 0xff, 0xff);
+	SDL_SetTextureAlphaMod(texture, SDL_ALPHA_OPAQUE);
+	SDL_SetTextureBlendMode(texture, blendMode);
+
+	ret = SDL_RenderGeometry(renderer, texture, vertices.data(), int(vertices.size()), indices.data(), int(indices.size()));
+	if (ret != 0) {
+		Log(ERROR, "SDLVideo", "{}", SDL_GetError());
+	}
+
+	vertices.clear();
+	indices.clear();
+#endif
+	return ret;
+}
+
+}
@@ -0,0 +1,67 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Collects consecutive sprite blits that share a texture, blend mode,
+// render target and clip rect, and draws them with one SDL_RenderGeometry
+// call instead of a SDL_RenderCopyEx each. Blits are never reordered, so
+// anything else that touches the renderer has to Flush() first.
+
+#ifndef SDLRENDERBATCH_H
+#define SDLRENDERBATCH_H
+
+#include <SDL.h>
+#include <utility>
+#include <vector>
+
+namespace GemRB {
+
+class SDLRenderBatch {
+	SDL_Renderer* renderer;
+	bool enabled = false;
+
+	SDL_Texture* target = nullptr;
+	SDL_Texture* texture = nullptr;
+	SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+	bool clipped = false;
+	SDL_Rect clip {};
+	float texW = 1.0f;
+	float texH = 1.0f;
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+#endif
+
+public:
+	SDLRenderBatch(SDL_Renderer* renderer, bool enabled) noexcept;
+	SDLRenderBatch(const SDLRenderBatch&) = delete;
+	SDLRenderBatch& operator=(const SDLRenderBatch&) = delete;
+
+	bool Enabled() const noexcept { return enabled; }
+
+	// clip is nullptr for the whole target; false if batching isn't available
+	bool AddQuad(SDL_Texture* target, const SDL_Rect* clip, SDL_Texture* texture, SDL_BlendMode blend,
+		     const SDL_Rect& src, const SDL_Rect& dst, const SDL_Color& mod, SDL_RendererFlip flip);
+	int Flush();
+};
+
+}
+
+#endif
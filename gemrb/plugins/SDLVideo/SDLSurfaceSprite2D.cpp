@@ -298,6 +298,9 @@ SDLTextureSprite2D::SDLTextureSprite2D(const Region& rgn, const PixelFormat& fmt
 SDLTextureSprite2D::~SDLTextureSprite2D() noexcept
 {
 	SDL_DestroyTexture(texture);
+	if (auto pages = atlas.lock()) {
+		pages->Release(atlasSlot);
+	}
 }
 
 SDLTextureSprite2D::SDLTextureSprite2D(const SDLTextureSprite2D& other) noexcept
@@ -329,6 +332,35 @@ SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer) const
 	return texture;
 }
 
+SDL_Texture* SDLTextureSprite2D::GetTexture(SDL_Renderer* renderer, const std::shared_ptr<SDLTextureAtlas>& pages, Point& offset) const
+{
+	// once a sprite has its own texture it keeps it
+	if (texture == nullptr && pages && pages->Accepts(Frame.size)) {
+		SDL_Texture* page = pages->Acquire(atlasSlot);
+		if (page && staleTexture) {
+			page = pages->Upload(atlasSlot, GetSurface()) ? page : nullptr;
+		} else if (!page && pages->Allocate(Frame.size, atlasSlot)) {
+			// never placed before or our page got recycled
+			atlas = pages;
+			if (pages->Upload(atlasSlot, GetSurface())) {
+				page = pages->Acquire(atlasSlot);
+			} else {
+				pages->Release(atlasSlot);
+			}
+		}
+
+		if (page) {
+			staleTexture = false;
+			offset = atlasSlot.rect.origin;
+			return page;
+		}
+		pages->Release(atlasSlot);
+	}
+
+	offset = Point();
+	return GetTexture(renderer);
+}
+
 void SDLTextureSprite2D::OnSurfaceUpdate() const noexcept
 {
 	staleTexture = true;
@@ -26,6 +26,12 @@
 
 #include <SDL.h>
 
+#if SDL_VERSION_ATLEAST(1, 3, 0)
+	#include "SDLTextureAtlas.h"
+
+	#include <memory>
+#endif
+
 namespace GemRB {
 
 class SDLSurfaceSprite2D : public Sprite2D {
@@ -85,6 +91,8 @@ class SDLTextureSprite2D : public SDLSurfaceSprite2D {
 	mutable Uint32 texFormat = SDL_PIXELFORMAT_UNKNOWN;
 	mutable SDL_Texture* texture = nullptr;
 	mutable bool staleTexture = false;
+	mutable std::weak_ptr<SDLTextureAtlas> atlas;
+	mutable SDLTextureAtlas::Slot atlasSlot;
 
 	void OnSurfaceUpdate() const noexcept override;
 
@@ -97,6 +105,13 @@ public:
 	Holder<Sprite2D> copy() const override;
 
 	SDL_Texture* GetTexture(SDL_Renderer* renderer) const;
+	// like above, but small sprites may end up in a shared atlas page
+	// offset is where the sprite pixels start in the returned texture
+	SDL_Texture* GetTexture(SDL_Renderer* renderer, const std::shared_ptr<SDLTextureAtlas>& pages, Point& offset) const;
+	// the next GetTexture will overwrite texture contents
+	bool NeedsUpload() const noexcept { return staleTexture; }
+	// the sprite got drawn from a shared atlas page the last time
+	bool InAtlas() const noexcept { return texture == nullptr && atlasSlot.generation != 0; }
 };
 #endif
 
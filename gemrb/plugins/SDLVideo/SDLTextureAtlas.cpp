@@ -0,0 +1,212 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "SDLTextureAtlas.h"
+
+#include "Logging/Logging.h"
+
+#include <cstring>
+
+namespace GemRB {
+
+SDLTextureAtlas::SDLTextureAtlas(SDL_Renderer* renderer, int pageSize, size_t maxPages) noexcept
+	: renderer(renderer), pageSize(pageSize), maxPages(maxPages)
+{}
+
+SDLTextureAtlas::~SDLTextureAtlas() noexcept
+{
+	Reset();
+}
+
+bool SDLTextureAtlas::Accepts(const Size& size) const noexcept
+{
+	if (size.IsInvalid()) return false;
+	int limit = pageSize - 2 * GUTTER;
+	if (limit > MAX_SPRITE_SIZE) limit = MAX_SPRITE_SIZE;
+	return size.w <= limit && size.h <= limit;
+}
+
+bool SDLTextureAtlas::Allocate(const Size& size, Slot& slot)
+{
+	Release(slot);
+	if (!Accepts(size)) return false;
+
+	// keep filling the page we used last, that is what groups related sprites
+	if (currentPage < pages.size() && Place(currentPage, size, slot)) {
+		return true;
+	}
+
+	for (size_t i = 0; i < pages.size(); ++i) {
+		if (i != currentPage && Place(i, size, slot)) {
+			currentPage = i;
+			return true;
+		}
+	}
+
+	if (pages.size() < maxPages && AddPage()) {
+		currentPage = pages.size() - 1;
+		return Place(currentPage, size, slot);
+	}
+
+	// everything is full, so recycle the page that went undrawn the longest
+	// pages drawn this very frame are left alone, the sprite is better off with its own texture
+	size_t victim = pages.size();
+	for (size_t i = 0; i < pages.size(); ++i) {
+		if (pages[i].lastUsed == frame) continue;
+		if (victim == pages.size() || pages[i].lastUsed < pages[victim].lastUsed) {
+			victim = i;
+		}
+	}
+	if (victim == pages.size()) return false;
+
+	Wipe(pages[victim]);
+	currentPage = victim;
+	return Place(currentPage, size, slot);
+}
+
+bool SDLTextureAtlas::Place(size_t pageIdx, const Size& size, Slot& slot)
+{
+	Page& page = pages[pageIdx];
+	int w = size.w + 2 * GUTTER;
+	int h = size.h + 2 * GUTTER;
+
+	// best fitting shelf, unless it would waste too much height and a new one is possible
+	Shelf* best = nullptr;
+	for (Shelf& shelf : page.shelves) {
+		if (shelf.h < h || shelf.x + w > pageSize) continue;
+		if (!best || shelf.h < best->h) {
+			best = &shelf;
+		}
+	}
+
+	bool roomForShelf = page.nextShelf + h <= pageSize;
+	if (!best || (best->h - h > h / 2 && roomForShelf)) {
+		if (!roomForShelf) return false;
+		page.shelves.push_back({ page.nextShelf, h, 0 });
+		page.nextShelf += h;
+		best = &page.shelves.back();
+	}
+
+	slot.page = pageIdx;
+	slot.generation = page.generation;
+	slot.rect = Region(best->x + GUTTER, best->y + GUTTER, size.w, size.h);
+	best->x += w;
+	++page.live;
+	page.lastUsed = frame;
+	return true;
+}
+
+bool SDLTextureAtlas::AddPage()
+{
+	SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, pageSize, pageSize);
+	if (!texture) {
+		Log(WARNING, "SDL 2 Driver", "Unable to create a sprite atlas page: {}", SDL_GetError());
+		// don't try again, sprites will just use their own textures
+		maxPages = pages.size();
+		return false;
+	}
+
+	pages.emplace_back();
+	pages.back().texture = texture;
+	Wipe(pages.back());
+	return true;
+}
+
+void SDLTextureAtlas::Wipe(Page& page) noexcept
+{
+	page.generation = nextGeneration++;
+	page.live = 0;
+	page.nextShelf = 0;
+	page.shelves.clear();
+}
+
+SDL_Texture* SDLTextureAtlas::Acquire(const Slot& slot) noexcept
+{
+	if (slot.generation == 0 || slot.page >= pages.size()) return nullptr;
+
+	Page& page = pages[slot.page];
+	if (page.generation != slot.generation) return nullptr;
+
+	page.lastUsed = frame;
+	return page.texture;
+}
+
+bool SDLTextureAtlas::Upload(const Slot& slot, SDL_Surface* surface)
+{
+	SDL_Texture* texture = Acquire(slot);
+	if (!texture) return false;
+
+	SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+	if (!converted) {
+		Log(ERROR, "SDL 2 Driver", "{}", SDL_GetError());
+		return false;
+	}
+
+	// upload the gutter too, so filtering never picks up the neighbours
+	int w = slot.rect.w + 2 * GUTTER;
+	int h = slot.rect.h + 2 * GUTTER;
+	uploadBuffer.assign(size_t(w) * size_t(h), 0);
+	const uint8_t* src = static_cast<const uint8_t*>(converted->pixels);
+	for (int y = 0; y < slot.rect.h; ++y) {
+		Uint32* dst = &uploadBuffer[size_t(y + GUTTER) * size_t(w) + GUTTER];
+		std::memcpy(dst, src + y * converted->pitch, slot.rect.w * sizeof(Uint32));
+	}
+	SDL_FreeSurface(converted);
+
+	SDL_Rect rect = { slot.rect.x - GUTTER, slot.rect.y - GUTTER, w, h };
+	if (SDL_UpdateTexture(texture, &rect, uploadBuffer.data(), w * int(sizeof(Uint32))) != 0) {
+		Log(ERROR, "SDL 2 Driver", "{}", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+void SDLTextureAtlas::Release(Slot& slot) noexcept
+{
+	if (slot.generation && slot.page < pages.size()) {
+		Page& page = pages[slot.page];
+		// the space can only be reused once the whole page is free, see NextFrame
+		if (page.generation == slot.generation) {
+			--page.live;
+		}
+	}
+	slot.generation = 0;
+}
+
+void SDLTextureAtlas::NextFrame() noexcept
+{
+	for (Page& page : pages) {
+		if (page.live == 0 && !page.shelves.empty()) {
+			Wipe(page);
+		}
+	}
+	++frame;
+}
+
+void SDLTextureAtlas::Reset() noexcept
+{
+	for (const Page& page : pages) {
+		SDL_DestroyTexture(page.texture);
+	}
+	pages.clear();
+	currentPage = 0;
+}
+
+}
@@ -0,0 +1,103 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+// Shared texture pages for small sprites (BAM frames, tiles, fonts), so the
+// renderer doesn't have to switch textures for every single blit.
+// Sprites are packed onto shelves in the order they are first drawn, which
+// keeps the frames of an animation or the tiles of an overlay together.
+// When all pages are full, the least recently drawn one is wiped; sprites
+// that lived there notice it from the page generation and get reuploaded.
+// Pages are never wiped while they may still be drawn from in this frame.
+
+#ifndef SDLTEXTUREATLAS_H
+#define SDLTEXTUREATLAS_H
+
+#include "Region.h"
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+
+namespace GemRB {
+
+class SDLTextureAtlas {
+public:
+	struct Slot {
+		size_t page = 0;
+		uint32_t generation = 0; // 0: not placed
+		Region rect; // the sprite pixels, without the gutter
+	};
+
+private:
+	struct Shelf {
+		int y;
+		int h;
+		int x;
+	};
+
+	struct Page {
+		SDL_Texture* texture = nullptr;
+		uint32_t generation = 0;
+		uint32_t lastUsed = 0;
+		size_t live = 0;
+		int nextShelf = 0;
+		std::vector<Shelf> shelves;
+	};
+
+	static constexpr int GUTTER = 1;
+	static constexpr int MAX_SPRITE_SIZE = 256;
+
+	SDL_Renderer* renderer;
+	int pageSize;
+	size_t maxPages;
+	uint32_t frame = 1;
+	uint32_t nextGeneration = 1;
+	size_t currentPage = 0;
+	std::vector<Page> pages;
+	std::vector<Uint32> uploadBuffer;
+
+	bool Place(size_t pageIdx, const Size& size, Slot& slot);
+	bool AddPage();
+	void Wipe(Page& page) noexcept;
+
+public:
+	SDLTextureAtlas(SDL_Renderer* renderer, int pageSize, size_t maxPages) noexcept;
+	SDLTextureAtlas(const SDLTextureAtlas&) = delete;
+	~SDLTextureAtlas() noexcept;
+	SDLTextureAtlas& operator=(const SDLTextureAtlas&) = delete;
+
+	// whether a sprite of this size should go to the atlas at all
+	bool Accepts(const Size& size) const noexcept;
+	// finds room for the sprite, false if it has to use its own texture instead
+	bool Allocate(const Size& size, Slot& slot);
+	// the page texture of a placed sprite or nullptr if it has been evicted since
+	SDL_Texture* Acquire(const Slot& slot) noexcept;
+	bool Upload(const Slot& slot, SDL_Surface* surface);
+	void Release(Slot& slot) noexcept;
+
+	// also recycles the pages that were emptied during the frame
+	void NextFrame() noexcept;
+	// drops all pages, eg. when the renderer lost its textures
+	void Reset() noexcept;
+};
+
+}
+
+#endif
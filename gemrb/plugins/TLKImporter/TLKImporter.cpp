@@ -31,7 +31,9 @@
 #include "GUI/GameControl.h"
 #include "Logging/Logging.h"
 #include "Scriptable/Actor.h"
+#include "Streams/MemoryStream.h"
 
+#include <algorithm>
 #include <tuple>
 #include <utility>
 
@@ -95,6 +97,13 @@ bool TLKImporter::Open(DataStream* stream)
 	}
 	delete str;
 	str = stream;
+	entries.clear();
+	stringCache.clear();
+	stringCacheIndex.clear();
+	// mapped files can be used in place
+	auto memory = dynamic_cast<MemoryStream*>(str);
+	mappedData = memory ? memory->GetData() : nullptr;
+
 	char Signature[8];
 	str->Read(Signature, 8);
 	if (strncmp(Signature, "TLK\x20V1\x20\x20", 8) != 0) {
@@ -109,7 +118,19 @@ bool TLKImporter::Open(DataStream* stream)
 		return false;
 	}
 
-	if (GetString(ieStrRef(1)).back() == u'\n') {
+	// the entry table is small, so parse it once instead of seeking for every string
+	entries.resize(std::min<strpos_t>(StrRefCount, str->Remains() / 0x1A));
+	for (Entry& entry : entries) {
+		str->ReadWord(entry.type);
+		str->ReadResRef(entry.sound);
+		// volume and pitch variance fields are known to be unused at minimum in bg1
+		str->Seek(8, GEM_CURRENT_POS);
+		str->ReadDword(entry.offset);
+		str->ReadDword(entry.length);
+	}
+
+	String first = entries.size() > 1 ? ReadString(entries[1]) : String();
+	if (!first.empty() && first.back() == u'\n') {
 		hasEndingNewline = true;
 	}
 
@@ -334,68 +355,116 @@ ieStrRef TLKImporter::UpdateString(ieStrRef strref, const String& newvalue)
 	return OverrideTLK->UpdateString(strref, newvalue);
 }
 
+String TLKImporter::ReadString(const Entry& entry)
+{
+	if (!(entry.type & 1)) {
+		return u"";
+	}
+
+	strpos_t start = strpos_t(Offset) + entry.offset;
+	if (mappedData) {
+		if (start + entry.length > str->Size()) {
+			return u"";
+		}
+		return StringFromTLK(StringView(mappedData + start, entry.length));
+	}
+
+	if (str->Seek(start, GEM_STREAM_START) == GEM_ERROR) {
+		return u"";
+	}
+	readBuffer.assign(entry.length, '\0');
+	str->Read(&readBuffer[0], entry.length);
+	return StringFromTLK(readBuffer);
+}
+
+String TLKImporter::FinishString(ieStrRef strref, String string, ieWord type, STRING_FLAGS flags)
+{
+	if (bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4)) {
+		string = ResolveTags(string);
+	}
+	if (bool(flags & STRING_FLAGS::STRREFON)) {
+		string = fmt::format(u"{}: {}", ieDword(strref), string);
+	}
+	if (hasEndingNewline) {
+		RTrim(string, u"\n");
+	}
+	return string;
+}
+
+void TLKImporter::PlaySound(const Entry& entry, STRING_FLAGS flags) const
+{
+	if (!(entry.type & 2) || !bool(flags & STRING_FLAGS::SOUND) || entry.sound.IsEmpty()) {
+		return;
+	}
+
+	// Narrator's error announcements (ambush, incomplete party)
+	SFXChannel channel = entry.sound.BeginsWith("ERROR") ? SFXChannel::Narrator : SFXChannel::Dialog;
+	auto config = core->GetAudioSettings().ConfigPresetDialog(channel);
+
+	bool speech = bool(flags & STRING_FLAGS::SPEECH);
+	if (speech) {
+		bool interrupt = uint32_t(flags & STRING_FLAGS::ALLOW_ZERO) == 0;
+		core->GetAudioPlayback().PlaySpeech(entry.sound, config, interrupt);
+		core->strrefHandle.reset();
+	} else {
+		core->strrefHandle = core->GetAudioPlayback().Play(entry.sound, config);
+	}
+}
+
+const String* TLKImporter::FindCached(uint64_t key)
+{
+	auto lookup = stringCacheIndex.find(key);
+	if (lookup == stringCacheIndex.end()) {
+		return nullptr;
+	}
+
+	stringCache.splice(stringCache.end(), stringCache, lookup->second);
+	return &lookup->second->second;
+}
+
+void TLKImporter::AddCached(uint64_t key, const String& string)
+{
+	if (stringCache.size() >= STRING_CACHE_SIZE) {
+		stringCacheIndex.erase(stringCache.front().first);
+		stringCache.pop_front();
+	}
+	stringCacheIndex[key] = stringCache.emplace(stringCache.end(), key, string);
+}
+
 String TLKImporter::GetString(ieStrRef strref, STRING_FLAGS flags)
 {
-	String string;
 	bool empty = !(flags & STRING_FLAGS::ALLOW_ZERO) && !strref;
-	ieWord type;
-	ResRef SoundResRef;
 
 	if (empty || strref >= ieStrRef::OVERRIDE_START || (strref >= ieStrRef::BIO_START && strref <= ieStrRef::BIO_END)) {
+		String string;
 		if (OverrideTLK) {
 			size_t Length;
 			char* cstr = OverrideTLK->ResolveAuxString(strref, Length);
 			string = StringFromTLK(StringView(cstr, Length));
 			free(cstr);
 		}
-		type = 0;
-		SoundResRef.Reset();
-	} else {
-		ieDword Volume, Pitch, StrOffset;
-		ieDword l;
-		if (str->Seek(18 + (ieDword(strref) * 0x1A), GEM_STREAM_START) == GEM_ERROR) {
-			return u"";
-		}
-		str->ReadWord(type);
-		str->ReadResRef(SoundResRef);
-		// volume and pitch variance fields are known to be unused at minimum in bg1
-		str->ReadDword(Volume);
-		str->ReadDword(Pitch);
-		str->ReadDword(StrOffset);
-		str->ReadDword(l);
-
-		if (type & 1) {
-			if (str->Seek(StrOffset + Offset, GEM_STREAM_START) == GEM_ERROR) {
-				return u"";
-			}
-			std::string mbstr(l, '\0');
-			str->Read(&mbstr[0], l);
-			string = StringFromTLK(mbstr);
-		}
+		return FinishString(strref, std::move(string), 0, flags);
 	}
 
-	if (bool(flags & STRING_FLAGS::RESOLVE_TAGS) || (type & 4)) {
-		string = ResolveTags(string);
+	if (ieDword(strref) >= entries.size()) {
+		return u"";
 	}
-	if ((type & 2) && bool(flags & STRING_FLAGS::SOUND) && !SoundResRef.IsEmpty()) {
-		// Narrator's error announcements (ambush, incomplete party)
-		SFXChannel channel = SoundResRef.BeginsWith("ERROR") ? SFXChannel::Narrator : SFXChannel::Dialog;
-		auto config = core->GetAudioSettings().ConfigPresetDialog(channel);
+	const Entry& entry = entries[ieDword(strref)];
+	PlaySound(entry, flags);
 
-		bool speech = bool(flags & STRING_FLAGS::SPEECH);
-		if (speech) {
-			bool interrupt = uint32_t(flags & STRING_FLAGS::ALLOW_ZERO) == 0;
-			core->GetAudioPlayback().PlaySpeech(SoundResRef, config, interrupt);
-			core->strrefHandle.reset();
-		} else {
-			core->strrefHandle = core->GetAudioPlayback().Play(SoundResRef, config);
+	// tags depend on the game state, the rest only on the text and STRREFON
+	bool cacheable = !(flags & STRING_FLAGS::RESOLVE_TAGS) && !(entry.type & 4);
+	uint64_t key = (uint64_t(strref) << 1) | uint64_t(bool(flags & STRING_FLAGS::STRREFON));
+	if (cacheable) {
+		const String* cached = FindCached(key);
+		if (cached) {
+			return *cached;
 		}
 	}
-	if (bool(flags & STRING_FLAGS::STRREFON)) {
-		string = fmt::format(u"{}: {}", ieDword(strref), string);
-	}
-	if (hasEndingNewline) {
-		RTrim(string, u"\n");
+
+	String string = FinishString(strref, ReadString(entry), entry.type, flags);
+	if (cacheable) {
+		AddCached(key, string);
 	}
 	return string;
 }
@@ -409,17 +478,10 @@ bool TLKImporter::HasAltTLK() const
 StringBlock TLKImporter::GetStringBlock(ieStrRef strref, STRING_FLAGS flags)
 {
 	bool empty = !(flags & STRING_FLAGS::ALLOW_ZERO) && !strref;
-	if (empty) {
-		return StringBlock();
-	}
-	ieWord type;
-	if (str->Seek(18 + (ieDword(strref) * 0x1A), GEM_STREAM_START) == GEM_ERROR) {
+	if (empty || ieDword(strref) >= entries.size()) {
 		return StringBlock();
 	}
-	str->ReadWord(type);
-	ResRef soundRef;
-	str->ReadResRef(soundRef);
-	return StringBlock(GetString(strref, flags), soundRef);
+	return StringBlock(GetString(strref, flags), entries[ieDword(strref)].sound);
 }
 
 #include "plugindef.h"
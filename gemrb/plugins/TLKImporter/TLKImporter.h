@@ -26,6 +26,11 @@
 #include "StringMgr.h"
 #include "TlkOverride.h"
 
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 namespace GemRB {
 
 struct gt_type {
@@ -36,7 +41,23 @@ struct gt_type {
 
 class TLKImporter : public StringMgr {
 private:
+	struct Entry {
+		ieWord type = 0;
+		ResRef sound;
+		ieDword offset = 0;
+		ieDword length = 0;
+	};
+
+	// strings resolved without the game state, so they can be reused
+	static constexpr size_t STRING_CACHE_SIZE = 4096;
+	using CachedStrings = std::list<std::pair<uint64_t, String>>;
+
 	DataStream* str = nullptr;
+	const char* mappedData = nullptr; // the whole file, if it is in memory anyway
+	std::vector<Entry> entries;
+	std::string readBuffer;
+	CachedStrings stringCache; // least recently used first
+	std::unordered_map<uint64_t, CachedStrings::iterator> stringCacheIndex;
 
 	//Data
 	ieWord Language = 0;
@@ -73,6 +94,12 @@ private:
 	ieStrRef GenderStrRef(int slot, ieStrRef malestrref, ieStrRef femalestrref) const;
 	String Gabber() const;
 	String CharName(int slot) const;
+
+	String ReadString(const Entry& entry);
+	String FinishString(ieStrRef strref, String string, ieWord type, STRING_FLAGS flags);
+	void PlaySound(const Entry& entry, STRING_FLAGS flags) const;
+	const String* FindCached(uint64_t key);
+	void AddCached(uint64_t key, const String& string);
 };
 
 }
@@ -123,6 +123,32 @@ TEST_P(p2DAImporterTest, FindTableValueByLong)
 	EXPECT_EQ(unit.FindTableValue(4, 17, 0), p2DAImporter::npos);
 }
 
+TEST_P(p2DAImporterTest, IndicesIgnoreCase)
+{
+	EXPECT_EQ(unit.GetRowIndex(std::string { "squeezeness" }), 6);
+	EXPECT_EQ(unit.GetColumnIndex(std::string { "Stat_Id" }), 3);
+	const TableMgr& table = unit;
+	EXPECT_EQ(table.QueryField(std::string { "wisdom" }, std::string { "cap_ref" }), std::string { "1180" });
+}
+
+TEST_P(p2DAImporterTest, QueryNumber)
+{
+	long value = 0;
+	EXPECT_TRUE(unit.QueryNumber(0, 0, value));
+	EXPECT_EQ(value, 11975);
+	EXPECT_FALSE(unit.QueryNumber(0, 3, value));
+	EXPECT_EQ(value, 0);
+	// missing cells are the default
+	EXPECT_TRUE(unit.QueryNumber(6, 3, value));
+	EXPECT_EQ(value, -1);
+	EXPECT_TRUE(unit.QueryNumber(20, 20, value));
+	EXPECT_EQ(value, -1);
+
+	EXPECT_EQ(unit.QueryFieldSigned<int>(std::string { "MADNESS" }, std::string { "DESC_REF" }), 34);
+	EXPECT_EQ(unit.QueryFieldSigned<int8_t>(0, 0), 127);
+	EXPECT_EQ(unit.QueryFieldSigned<int>(1, 3), 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(
 	2DAImporterInstances,
 	p2DAImporterTest,
@@ -0,0 +1,142 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../../core/Audio/BufferCache.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+class TestBuffer : public SoundBufferHandle {
+public:
+	bool playing = false;
+
+	bool Disposable() override { return !playing; }
+};
+
+static BufferCacheEntry MakeEntry(Holder<TestBuffer>* buffer = nullptr)
+{
+	auto handle = MakeHolder<TestBuffer>();
+	if (buffer) *buffer = handle;
+	return BufferCacheEntry(handle, 100);
+}
+
+static std::shared_ptr<const EncodedSound> MakeEncoded(size_t size)
+{
+	return std::make_shared<const EncodedSound>(std::vector<char>(size));
+}
+
+TEST(AudioBufferCacheTest, CountsHitsAndMisses)
+{
+	AudioBufferCache cache { 0 };
+	EXPECT_EQ(cache.Lookup("a"), nullptr);
+	cache.SetAt("a", MakeEntry(), 10);
+	EXPECT_NE(cache.Lookup("a"), nullptr);
+	EXPECT_NE(cache.Peek("a"), nullptr);
+
+	EXPECT_EQ(cache.GetStats().hits, 1U);
+	EXPECT_EQ(cache.GetStats().misses, 1U);
+	EXPECT_EQ(cache.GetUsage(), 10U);
+}
+
+TEST(AudioBufferCacheTest, EvictsLeastRecentlyPlayed)
+{
+	AudioBufferCache cache { 25 };
+	cache.SetAt("a", MakeEntry(), 10);
+	cache.SetAt("b", MakeEntry(), 10);
+	cache.Lookup("a");
+	cache.SetAt("c", MakeEntry(), 10);
+
+	EXPECT_EQ(cache.Peek("b"), nullptr);
+	EXPECT_NE(cache.Peek("a"), nullptr);
+	EXPECT_NE(cache.Peek("c"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 20U);
+	EXPECT_EQ(cache.GetStats().evictions, 1U);
+}
+
+TEST(AudioBufferCacheTest, KeepsPlayingSounds)
+{
+	AudioBufferCache cache { 15 };
+	Holder<TestBuffer> buffer;
+	cache.SetAt("playing", MakeEntry(&buffer), 10);
+	buffer->playing = true;
+	cache.SetAt("big", MakeEntry(), 10);
+
+	EXPECT_NE(cache.Peek("playing"), nullptr);
+	EXPECT_NE(cache.Peek("big"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 20U);
+
+	// once it is done, it can go
+	buffer->playing = false;
+	cache.SetAt("next", MakeEntry(), 5);
+	EXPECT_EQ(cache.Peek("playing"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 15U);
+}
+
+TEST(AudioBufferCacheTest, KeepsHotSoundsEncoded)
+{
+	AudioBufferCache cache { 100, true };
+	cache.SetAt("hot", MakeEntry(), 60, MakeEncoded(10));
+	cache.SetAt("cold", MakeEntry(), 10, MakeEncoded(5));
+	for (unsigned int i = 0; i < AudioBufferCache::HOT_HITS; ++i) {
+		cache.Lookup("hot");
+	}
+	cache.Lookup("cold");
+	EXPECT_EQ(cache.GetUsage(), 85U);
+
+	cache.SetAt("new", MakeEntry(), 50);
+	EXPECT_EQ(cache.Lookup("hot"), nullptr);
+	EXPECT_NE(cache.GetEncoded("hot"), nullptr);
+	EXPECT_NE(cache.Peek("cold"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 10U + 15U + 50U);
+
+	// decoded again, the encoded copy stays with it
+	cache.SetAt("hot", MakeEntry(), 60);
+	EXPECT_NE(cache.Peek("hot"), nullptr);
+	EXPECT_NE(cache.GetEncoded("hot"), nullptr);
+	EXPECT_EQ(cache.GetStats().encodedHits, 2U);
+}
+
+TEST(AudioBufferCacheTest, DropsEncodedCopiesLast)
+{
+	AudioBufferCache cache { 30, true };
+	cache.SetAt("hot", MakeEntry(), 10, MakeEncoded(5));
+	cache.Lookup("hot");
+	cache.Lookup("hot");
+	cache.SetAt("a", MakeEntry(), 15);
+	// first only the decoded part of "hot" goes, then its encoded copy too
+	cache.SetAt("b", MakeEntry(), 10);
+	EXPECT_NE(cache.GetEncoded("hot"), nullptr);
+	cache.SetAt("c", MakeEntry(), 5);
+	EXPECT_NE(cache.GetEncoded("hot"), nullptr);
+	cache.SetAt("d", MakeEntry(), 26);
+	EXPECT_EQ(cache.GetEncoded("hot"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 26U);
+}
+
+TEST(AudioBufferCacheTest, IgnoresEncodedWhenDisabled)
+{
+	AudioBufferCache cache { 0 };
+	cache.SetAt("a", MakeEntry(), 10, MakeEncoded(5));
+	EXPECT_EQ(cache.GetEncoded("a"), nullptr);
+	EXPECT_EQ(cache.GetUsage(), 10U);
+}
+
+}
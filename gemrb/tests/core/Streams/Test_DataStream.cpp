@@ -20,6 +20,7 @@
 #include "Streams/FileStream.h"
 #include "Streams/MappedFileMemoryStream.h"
 #include "Streams/MemoryStream.h"
+#include "Streams/MemoryViewStream.h"
 #include "System/VFS.h"
 
 #include <gtest/gtest.h>
@@ -230,18 +231,26 @@ static DataStream* createMMapStream(const path_t& path)
 	return new MappedFileMemoryStream(path);
 }
 
+static DataStream* createMemoryViewStream(const path_t& path)
+{
+	auto mapping = std::make_shared<MappedFileMemoryStream>(path);
+	return new MemoryViewStream(mapping, 0, mapping->Size());
+}
+
 INSTANTIATE_TEST_SUITE_P(
 	DataStreamReadingInstances,
 	DataStreamReadingTest,
 	testing::Values(
 		DataStreamFactory { createFileStream },
-		DataStreamFactory { createMMapStream }));
+		DataStreamFactory { createMMapStream },
+		DataStreamFactory { createMemoryViewStream }));
 
 INSTANTIATE_TEST_SUITE_P(
 	DataStreamDecryptingInstances,
 	DataStreamDecryptionTest,
 	testing::Values(
 		DataStreamFactory { createFileStream },
-		DataStreamFactory { createMMapStream }));
+		DataStreamFactory { createMMapStream },
+		DataStreamFactory { createMemoryViewStream }));
 
 }
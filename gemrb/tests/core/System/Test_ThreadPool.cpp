@@ -0,0 +1,58 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "System/ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace GemRB {
+
+TEST(ThreadPoolTest, Results)
+{
+	ThreadPool pool { 3 };
+	EXPECT_EQ(pool.Size(), 3U);
+
+	std::vector<std::future<int>> results;
+	for (int i = 0; i < 100; ++i) {
+		results.push_back(pool.Submit([i]() { return i * i; }));
+	}
+	for (int i = 0; i < 100; ++i) {
+		EXPECT_EQ(results[i].get(), i * i);
+	}
+}
+
+TEST(ThreadPoolTest, AllTasksRun)
+{
+	std::atomic<int> counter { 0 };
+	std::vector<std::future<void>> done;
+	ThreadPool pool {};
+	EXPECT_GE(pool.Size(), 1U);
+
+	for (int i = 0; i < 50; ++i) {
+		done.push_back(pool.Submit([&counter]() { ++counter; }));
+	}
+	for (auto& task : done) {
+		task.wait();
+	}
+	EXPECT_EQ(counter, 50);
+}
+
+}
@@ -0,0 +1,172 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../core/Cache.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+static size_t TenBytes(const int&)
+{
+	return 10;
+}
+
+TEST(RCCacheTest, DropsReleasedWithoutBudget)
+{
+	ResRefRCCache<int> cache;
+	*cache.SetAt("item").first = 5;
+	EXPECT_EQ(cache.DecRef("item", false), 0);
+	EXPECT_NE(cache.GetResource("item"), nullptr);
+	EXPECT_EQ(cache.DecRef("item", true), 0);
+	EXPECT_EQ(cache.GetResource("item"), nullptr);
+	EXPECT_EQ(cache.RefCount("item"), -1);
+}
+
+TEST(RCCacheTest, KeepsReleasedWithinBudget)
+{
+	CacheBudget budget { 25 };
+	ResRefRCCache<int> cache;
+	cache.SetBudget(&budget, TenBytes);
+
+	cache.SetAt("a");
+	cache.SetAt("b");
+	EXPECT_EQ(budget.GetUsage(), 0U);
+	cache.DecRef("a", true);
+	cache.DecRef("b", true);
+	EXPECT_EQ(budget.GetUsage(), 20U);
+
+	// reusing "a" makes "b" the least recently released one
+	ASSERT_NE(cache.GetResource("a"), nullptr);
+	cache.DecRef("a", true);
+	cache.SetAt("c");
+	cache.DecRef("c", true);
+
+	EXPECT_EQ(budget.GetUsage(), 20U);
+	EXPECT_EQ(cache.RefCount("b"), -1);
+	EXPECT_EQ(cache.RefCount("a"), 0);
+	EXPECT_EQ(cache.RefCount("c"), 0);
+}
+
+TEST(RCCacheTest, NeverEvictsReferenced)
+{
+	CacheBudget budget { 5 };
+	ResRefRCCache<int> cache;
+	cache.SetBudget(&budget, TenBytes);
+
+	cache.SetAt("held");
+	cache.SetAt("pinned");
+	cache.DecRef("pinned", false);
+	EXPECT_EQ(budget.GetUsage(), 10U);
+	EXPECT_EQ(cache.RefCount("pinned"), 0);
+	EXPECT_EQ(cache.RefCount("held"), 1);
+
+	// extra releases don't unpin
+	cache.DecRef("pinned", true);
+	EXPECT_EQ(cache.RefCount("pinned"), 0);
+}
+
+TEST(RCCacheTest, PeekDoesNotReference)
+{
+	CacheBudget budget {};
+	ResRefRCCache<int> cache;
+	cache.SetBudget(&budget, TenBytes);
+
+	*cache.SetAt("fx").first = 3;
+	cache.DecRef("fx", true);
+	const int* value = cache.Peek("fx");
+	ASSERT_NE(value, nullptr);
+	EXPECT_EQ(*value, 3);
+	EXPECT_EQ(cache.RefCount("fx"), 0);
+	EXPECT_EQ(cache.Peek("none"), nullptr);
+}
+
+TEST(SharedCacheTest, EvictsUnusedLeastRecentlyUsed)
+{
+	CacheBudget budget { 25 };
+	SharedCache<ResRef, int, CstrHashCI> cache;
+	cache.SetBudget(&budget);
+
+	auto held = cache.Set("held", std::make_shared<int>(1), 10);
+	cache.Set("old", std::make_shared<int>(2), 10);
+	cache.Set("fixed", std::make_shared<int>(3), 10, false);
+
+	// over budget, but only "old" may go
+	std::shared_ptr<int> found;
+	EXPECT_EQ(budget.GetUsage(), 20U);
+	EXPECT_FALSE(cache.Find("old", found));
+	ASSERT_TRUE(cache.Find("held", found));
+	EXPECT_EQ(*found, 1);
+	ASSERT_TRUE(cache.Find("fixed", found));
+	EXPECT_EQ(*found, 3);
+
+	// letting go of the last handle makes it evictable right away
+	found.reset();
+	budget.SetLimit(15);
+	EXPECT_EQ(budget.GetUsage(), 20U);
+	held.reset();
+	EXPECT_EQ(budget.GetUsage(), 10U);
+	EXPECT_FALSE(cache.Find("held", found));
+	ASSERT_TRUE(cache.Find("fixed", found));
+	EXPECT_EQ(*found, 3);
+}
+
+TEST(SharedCacheTest, ReacquiredEntriesAreKept)
+{
+	CacheBudget budget { 20 };
+	SharedCache<ResRef, int, CstrHashCI> cache;
+	cache.SetBudget(&budget);
+
+	cache.Set("first", std::make_shared<int>(1), 10);
+	cache.Set("second", std::make_shared<int>(2), 10);
+
+	// "first" is the older one, but in use again
+	std::shared_ptr<int> first;
+	ASSERT_TRUE(cache.Find("first", first));
+	cache.Set("third", std::make_shared<int>(3), 10);
+	std::shared_ptr<int> found;
+	EXPECT_FALSE(cache.Find("second", found));
+	EXPECT_TRUE(cache.Find("third", found));
+
+	// handles keep the object alive even once the cache drops it
+	cache.Clear();
+	EXPECT_EQ(budget.GetUsage(), 0U);
+	EXPECT_EQ(*first, 1);
+	first.reset();
+	EXPECT_FALSE(cache.Find("first", found));
+}
+
+TEST(SharedCacheTest, CachesMisses)
+{
+	CacheBudget budget {};
+	SharedCache<ResRef, int, CstrHashCI> cache;
+	cache.SetBudget(&budget);
+
+	cache.Set("missing", nullptr, 0);
+	std::shared_ptr<int> cached = std::make_shared<int>(0);
+	ASSERT_TRUE(cache.Find("missing", cached));
+	EXPECT_EQ(cached, nullptr);
+
+	cache.Clear();
+	EXPECT_FALSE(cache.Find("missing", cached));
+	EXPECT_EQ(budget.GetUsage(), 0U);
+}
+
+}
@@ -0,0 +1,151 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../core/EffectQueue.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace GemRB {
+
+static constexpr ieDword OPCODES = 6;
+
+static void AddEffect(EffectQueue& queue, ieDword opcode, ieDword param1, bool insert = false)
+{
+	Effect* fx = new Effect();
+	fx->Opcode = opcode;
+	fx->Parameter1 = param1;
+	fx->TimingMode = FX_DURATION_INSTANT_PERMANENT;
+	queue.AddEffect(fx, insert);
+}
+
+// the index has to hand out exactly what a walk over the whole queue finds
+static void CheckIndex(const EffectQueue& queue)
+{
+	for (ieDword opcode = 0; opcode < OPCODES; ++opcode) {
+		std::vector<const Effect*> scanned;
+		auto f = queue.GetFirstEffect();
+		while (const Effect* fx = queue.GetNextEffect(f)) {
+			if (fx->Opcode == opcode) scanned.push_back(fx);
+		}
+
+		std::vector<const Effect*> indexed;
+		for (const Effect& fx : queue.EffectsWithOpcode(opcode)) {
+			indexed.push_back(&fx);
+		}
+		EXPECT_EQ(indexed, scanned) << "opcode " << opcode;
+	}
+}
+
+static EffectQueue MakeQueue()
+{
+	EffectQueue queue;
+	for (ieDword i = 0; i < 20; ++i) {
+		AddEffect(queue, i % OPCODES, i, i % 3 == 0);
+	}
+	return queue;
+}
+
+TEST(EffectQueueTest, IndexAfterAdd)
+{
+	EffectQueue queue = MakeQueue();
+	EXPECT_EQ(queue.GetEffectsCount(), 20u);
+	CheckIndex(queue);
+}
+
+TEST(EffectQueueTest, IndexAfterRemove)
+{
+	EffectQueue queue = MakeQueue();
+	Effect match;
+	match.Opcode = 2;
+	match.Parameter1 = 8;
+	match.TimingMode = FX_DURATION_INSTANT_PERMANENT;
+	EXPECT_TRUE(queue.RemoveEffect(&match));
+	EXPECT_FALSE(queue.RemoveEffect(&match));
+	CheckIndex(queue);
+
+	// everything of one opcode, so its bucket goes away
+	for (ieDword param = 5; param < 20; param += OPCODES) {
+		match.Opcode = 5;
+		match.Parameter1 = param;
+		EXPECT_TRUE(queue.RemoveEffect(&match));
+	}
+	EXPECT_EQ(queue.GetEffectsCount(), 16u);
+	CheckIndex(queue);
+}
+
+TEST(EffectQueueTest, IndexAfterExpiry)
+{
+	EffectQueue queue = MakeQueue();
+	auto f = queue.GetFirstEffect();
+	while (Effect* fx = queue.GetNextEffect(f)) {
+		if (fx->Parameter1 % 4 == 1) fx->TimingMode = FX_DURATION_JUST_EXPIRED;
+	}
+	queue.Cleanup();
+	EXPECT_EQ(queue.GetEffectsCount(), 15u);
+	CheckIndex(queue);
+}
+
+TEST(EffectQueueTest, IndexAfterOpcodeChange)
+{
+	EffectQueue queue = MakeQueue();
+	// like the effects that turn into another opcode when applied
+	auto f = queue.GetFirstEffect();
+	while (Effect* fx = queue.GetNextEffect(f)) {
+		if (fx->Opcode == 1) fx->Opcode = 4;
+	}
+
+	// removal still finds them under the old opcode
+	Effect match;
+	match.Opcode = 4;
+	match.Parameter1 = 7;
+	match.TimingMode = FX_DURATION_INSTANT_PERMANENT;
+	EXPECT_TRUE(queue.RemoveEffect(&match));
+
+	// and copies are indexed from scratch
+	EffectQueue copy(queue);
+	CheckIndex(copy);
+	EffectQueue assigned;
+	AddEffect(assigned, 3, 100);
+	assigned = copy;
+	CheckIndex(assigned);
+	EXPECT_EQ(assigned.GetEffectsCount(), 19u);
+}
+
+TEST(EffectQueueTest, CopiesAreIndependent)
+{
+	EffectQueue queue = MakeQueue();
+	EffectQueue copy(queue);
+	AddEffect(copy, 0, 50);
+	CheckIndex(queue);
+	CheckIndex(copy);
+
+	// the copy's index must not point into the original
+	for (ieDword opcode = 0; opcode < OPCODES; ++opcode) {
+		for (const Effect& fx : copy.EffectsWithOpcode(opcode)) {
+			for (const Effect& orig : queue.EffectsWithOpcode(opcode)) {
+				EXPECT_NE(&fx, &orig);
+			}
+		}
+	}
+}
+
+}
@@ -20,17 +20,26 @@
 // FIXME: remove once fixed, this is excluding non-linux build bots
 #if defined(USE_OPENGL_BACKEND) || (!defined(__APPLE__) && !defined(WIN32))
 
+#include "../../core/Debug.h"
+#include "../../core/EffectQueue.h"
+#include "../../core/Game.h"
 #include "../../core/GameData.h"
+#include "../../core/GameScript/GameScript.h"
 #include "../../core/Interface.h"
 #include "../../core/InterfaceConfig.h"
 #include "../../core/Logging/Loggers/Stdio.h"
 #include "../../core/Logging/Logging.h"
 #include "../../core/Map.h"
+#include "../../core/PathQueue.h"
 #include "../../core/PluginMgr.h"
 #include "../../core/SaveGameMgr.h"
+#include "../../core/Scriptable/Actor.h"
+#include "../../includes/ie_stats.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 namespace GemRB {
 
 class MapTest : public testing::Test {
@@ -150,5 +159,305 @@ TEST_F(MapTest, FindPathTest)
 	EXPECT_TRUE(path);
 	EXPECT_GT(path.Size(), 1);
 }
+
+// puts a fresh creature into the area as already initialized, since applying
+// the feats needs the GUIScripts, which the tests don't load
+static Actor* AddCreature(Map* area)
+{
+	Actor* actor = gamedata->GetCreature(ResRef("rabbit"));
+	if (actor) {
+		actor->SetInternalFlag(IF_GOTAREA, BitOp::OR);
+		area->AddActor(actor, true);
+	}
+	return actor;
+}
+
+// an actor with only plain stat modifiers gets its effects replayed from the
+// cache, which has to come out exactly like a full ApplyAllEffects
+TEST_F(MapTest, EffectReplayMatchesFullReplay)
+{
+	Map* area = core->GetGame()->GetMap(ResRef("ar0100"), false);
+	Actor* actor = AddCreature(area);
+	ASSERT_NE(actor, nullptr);
+	ieDword fireResistance = actor->GetStat(IE_RESISTFIRE);
+
+	static EffectRef fireRef = { "FireResistanceModifier", -1 };
+	static EffectRef saveRef = { "SaveVsDeathModifier", -1 };
+	static EffectRef luckRef = { "LuckModifier", -1 };
+	static EffectRef acRef = { "ACVsDamageTypeModifier", -1 };
+	static EffectRef toHitRef = { "ToHitModifier", -1 };
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(fireRef, 10, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(saveRef, 2, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(luckRef, 1, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	// deflection that two-handed weapons disable
+	Effect* acFx = EffectQueue::CreateEffect(acRef, 3, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED);
+	acFx->IsVariable = 1;
+	actor->fxqueue.AddEffect(acFx);
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(toHitRef, 2, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+
+	std::vector<EffectReplayKey> keys;
+	ASSERT_TRUE(actor->fxqueue.GetReplayKeys(keys, core->GetGame()->GameTime));
+	EXPECT_EQ(keys.size(), actor->fxqueue.GetEffectsCount());
+
+	// the first refresh initializes the creature, the second one fills the cache and the third uses it
+	Actor::ResetEffectCacheStats();
+	actor->RefreshEffects();
+	actor->RefreshEffects();
+	actor->RefreshEffects();
+	EXPECT_EQ(Actor::GetEffectCacheStats().uncacheable, 0u);
+	EXPECT_EQ(Actor::GetEffectCacheStats().misses, 1u);
+	EXPECT_EQ(Actor::GetEffectCacheStats().hits, 1u);
+	std::vector<ieDword> cachedStats(MAX_STATS);
+	for (unsigned int i = 0; i < MAX_STATS; ++i) {
+		cachedStats[i] = actor->GetStat(i);
+	}
+	ArmorClass cachedAC = actor->AC;
+	ToHitStats cachedToHit = actor->ToHit;
+	EXPECT_EQ(cachedStats[IE_RESISTFIRE], fireResistance + 10);
+
+	// the debug mode always replays in full
+	SetDebugMode(DebugMode::EFFECTS, BitOp::OR);
+	actor->RefreshEffects();
+	SetDebugMode(DebugMode::EFFECTS, BitOp::NAND);
+
+	for (unsigned int i = 0; i < MAX_STATS; ++i) {
+		EXPECT_EQ(actor->GetStat(i), cachedStats[i]) << "stat " << i;
+	}
+	EXPECT_TRUE(actor->AC == cachedAC) << actor->AC.GetTotal() << " vs " << cachedAC.GetTotal();
+	EXPECT_TRUE(actor->ToHit == cachedToHit) << actor->ToHit.GetTotal() << " vs " << cachedToHit.GetTotal();
+	EXPECT_EQ(Actor::GetEffectCacheStats().hits, 2u);
+
+	// anything the outcome depends on has to invalidate the cache
+	Effect* fireFx = actor->fxqueue.HasEffect(fireRef);
+	ASSERT_NE(fireFx, nullptr);
+	fireFx->Parameter1 = 20;
+	actor->RefreshEffects();
+	EXPECT_EQ(actor->GetStat(IE_RESISTFIRE), fireResistance + 20);
+
+	actor->SetBase(IE_RESISTFIRE, fireResistance + 5);
+	actor->RefreshEffects();
+	EXPECT_EQ(actor->GetStat(IE_RESISTFIRE), fireResistance + 25);
+	EXPECT_EQ(Actor::GetEffectCacheStats().misses, 3u);
+
+	int weaponSlot = Inventory::GetWeaponSlot();
+	CREItem* twoHanded = new CREItem();
+	twoHanded->ItemResRef = "fist";
+	twoHanded->Flags = IE_INV_ITEM_TWOHANDED;
+	actor->inventory.SetSlotItem(twoHanded, weaponSlot);
+	actor->RefreshEffects();
+	EXPECT_EQ(actor->AC.GetTotal(), cachedAC.GetTotal() + 3);
+
+	CREItem* oneHanded = new CREItem();
+	oneHanded->ItemResRef = "fist";
+	actor->inventory.SetSlotItem(oneHanded, weaponSlot);
+	actor->RefreshEffects();
+	EXPECT_EQ(actor->AC.GetTotal(), cachedAC.GetTotal());
+	EXPECT_EQ(Actor::GetEffectCacheStats().misses, 5u);
+	EXPECT_EQ(Actor::GetEffectCacheStats().hits, 2u);
+
+	area->RemoveActor(actor);
+	delete actor;
+}
+
+// a few effects turn into another opcode when applied, the index has to follow
+TEST_F(MapTest, EffectIndexFollowsMorphs)
+{
+	Map* area = core->GetGame()->GetMap(ResRef("ar0100"), false);
+	Actor* actor = AddCreature(area);
+	ASSERT_NE(actor, nullptr);
+
+	static EffectRef setStatRef = { "Stat:SetStat", -1 };
+	static EffectRef damageBonusRef = { "DamageBonusModifier2", -1 };
+	static EffectRef luckRef = { "LuckModifier", -1 };
+	// acid damage bonus, which is a separate opcode for us
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(setStatRef, 10, 387, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	actor->fxqueue.AddEffect(EffectQueue::CreateEffect(luckRef, 1, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	actor->RefreshEffects();
+
+	const EffectQueue& queue = actor->fxqueue;
+	auto countIndexed = [&queue](ieDword opcode) {
+		size_t indexed = 0;
+		for (const Effect& fx : queue.EffectsWithOpcode(opcode)) {
+			EXPECT_EQ(fx.Opcode, opcode);
+			++indexed;
+		}
+		return indexed;
+	};
+	EXPECT_EQ(countIndexed(EffectQueue::ResolveEffect(setStatRef)), 0u);
+
+	// every opcode in the queue finds exactly its effects
+	std::vector<ieDword> opcodes;
+	auto f = queue.GetFirstEffect();
+	while (const Effect* fx = queue.GetNextEffect(f)) {
+		opcodes.push_back(fx->Opcode);
+	}
+	ieDword damageBonus = EffectQueue::ResolveEffect(damageBonusRef);
+	EXPECT_NE(std::find(opcodes.begin(), opcodes.end(), damageBonus), opcodes.end());
+	for (ieDword opcode : opcodes) {
+		EXPECT_EQ(countIndexed(opcode), size_t(std::count(opcodes.begin(), opcodes.end(), opcode))) << "opcode " << opcode;
+	}
+
+	area->RemoveActor(actor);
+	delete actor;
+}
+
+// the object selector lookups have to agree with a plain filter over the area actors
+static void CheckActorsByStat(const Map* area)
+{
+	for (unsigned int stat : { IE_EA, IE_RACE, IE_SPECIFIC }) {
+		std::vector<ActorStatIndex::Filter> filters;
+		for (const Actor* actor : area->GetAllActors()) {
+			ieDword value = actor->GetStat(stat);
+			filters.emplace_back([value](ieDword v) { return v == value; });
+		}
+		filters.emplace_back([](ieDword v) { return v == 12345; });
+		// like [GOODCUTOFF], several buckets at once
+		filters.emplace_back([](ieDword v) { return v <= EA_GOODCUTOFF; });
+
+		for (const auto& accept : filters) {
+			std::vector<Actor*> found;
+			ASSERT_TRUE(area->GetActorsByStat(stat, accept, found));
+			std::vector<Actor*> expected;
+			for (Actor* actor : area->GetAllActors()) {
+				if (accept(actor->GetStat(stat))) expected.push_back(actor);
+			}
+			EXPECT_EQ(found, expected) << "stat " << stat;
+		}
+	}
+}
+
+TEST_F(MapTest, ActorsByStatFollowChanges)
+{
+	Map* area = core->GetGame()->GetMap(ResRef("ar0100"), false);
+	Actor* first = AddCreature(area);
+	ASSERT_NE(first, nullptr);
+	CheckActorsByStat(area);
+	Actor* second = AddCreature(area);
+	ASSERT_NE(second, nullptr);
+	CheckActorsByStat(area);
+
+	first->SetBase(IE_EA, EA_ENEMY);
+	EXPECT_EQ(first->GetStat(IE_EA), ieDword(EA_ENEMY));
+	CheckActorsByStat(area);
+
+	second->SetStat(IE_RACE, 200, 1);
+	EXPECT_EQ(second->GetStat(IE_RACE), 200u);
+	CheckActorsByStat(area);
+
+	// through the effect replay
+	static EffectRef idsRef = { "AIIdentifierModifier", -1 };
+	second->fxqueue.AddEffect(EffectQueue::CreateEffect(idsRef, 77, 4, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	second->RefreshEffects();
+	EXPECT_EQ(second->GetStat(IE_SPECIFIC), 77u);
+	CheckActorsByStat(area);
+	second->fxqueue.AddEffect(EffectQueue::CreateEffect(idsRef, EA_ALLY, 0, FX_DURATION_INSTANT_WHILE_EQUIPPED));
+	second->RefreshEffects();
+	EXPECT_EQ(second->GetStat(IE_EA), ieDword(EA_ALLY));
+	CheckActorsByStat(area);
+
+	area->RemoveActor(first);
+	CheckActorsByStat(area);
+	area->RemoveActor(second);
+	CheckActorsByStat(area);
+	delete first;
+	delete second;
+}
+
+// queued walkers have to get the paths they'd get from NewPath one after the other
+TEST_F(MapTest, QueuedPathsMatchNewPath)
+{
+	Map* area = core->GetGame()->GetMap(ResRef("ar0100"), false);
+	Actor* first = AddCreature(area);
+	ASSERT_NE(first, nullptr);
+	Actor* second = AddCreature(area);
+	ASSERT_NE(second, nullptr);
+
+	// side by side, each walking through the other's spot
+	auto setUp = [first, second]() {
+		first->SetPosition(Point(900, 620), false);
+		second->SetPosition(Point(940, 620), false);
+		first->WalkTo(Point(1060, 620), 0);
+		second->WalkTo(Point(760, 620), 0);
+	};
+
+	setUp();
+	first->NewPath();
+	second->NewPath();
+	Path firstPath = first->GetPath();
+	Path secondPath = second->GetPath();
+	ASSERT_TRUE(firstPath);
+	ASSERT_TRUE(secondPath);
+	// they had to go around each other
+	EXPECT_GT(firstPath.Size(), 1u);
+	EXPECT_GT(secondPath.Size(), 1u);
+
+	setUp();
+	PathQueue queue;
+	queue.Submit(first);
+	queue.Submit(second);
+	queue.Solve(*area);
+
+	auto expectSamePath = [](const Path& path, const Path& expected) {
+		ASSERT_EQ(path.Size(), expected.Size());
+		for (size_t i = 0; i < path.Size(); ++i) {
+			EXPECT_EQ(path.GetStep(i).point, expected.GetStep(i).point) << "step " << i;
+			EXPECT_EQ(path.GetStep(i).orient, expected.GetStep(i).orient) << "step " << i;
+		}
+	};
+	expectSamePath(first->GetPath(), firstPath);
+	expectSamePath(second->GetPath(), secondPath);
+
+	area->RemoveActor(first);
+	area->RemoveActor(second);
+	delete first;
+	delete second;
+}
+
+// returns where each trigger ended up, as indices into the given ones
+static std::vector<size_t> ReorderTriggers(std::initializer_list<const char*> script)
+{
+	Condition condition;
+	for (const char* trigger : script) {
+		Trigger* tR = GenerateTrigger(trigger);
+		EXPECT_NE(tR, nullptr) << trigger;
+		if (tR) condition.triggers.push_back(tR);
+	}
+	std::vector<Trigger*> original = condition.triggers;
+	condition.ReorderTriggers();
+
+	std::vector<size_t> order;
+	for (const Trigger* tR : condition.triggers) {
+		order.push_back(std::find(original.begin(), original.end(), tR) - original.begin());
+	}
+	return order;
+}
+
+TEST_F(MapTest, ReorderTriggersKeepsBarriers)
+{
+	bool reorder = core->config.ReorderTriggers;
+	core->config.ReorderTriggers = true;
+	using order_t = std::vector<size_t>;
+
+	// costly triggers go last within runs of side effect free ones
+	EXPECT_EQ(ReorderTriggers({ "NumCreature(\"rabbit\",1)", "Global(\"a\",\"GLOBAL\",1)", "True()" }), (order_t { 1, 2, 0 }));
+
+	// but never past triggers with side effects
+	EXPECT_EQ(ReorderTriggers({ "Global(\"a\",\"GLOBAL\",1)", "NumCreature(\"rabbit\",1)", "Global(\"b\",\"GLOBAL\",1)",
+				    "See(\"rabbit\")", "NumCreature(\"rabbit\",2)", "True()" }),
+		  (order_t { 0, 2, 1, 3, 5, 4 }));
+
+	// nor into, out of or within Or() blocks
+	EXPECT_EQ(ReorderTriggers({ "NumCreature(\"rabbit\",1)", "Global(\"a\",\"GLOBAL\",1)", "OR(2)", "NumCreature(\"rabbit\",2)",
+				    "Global(\"b\",\"GLOBAL\",1)", "NumCreature(\"rabbit\",3)", "True()" }),
+		  (order_t { 1, 0, 2, 3, 4, 6, 5 }));
+
+	// and whatever NextTriggerObject retargets stays right after it
+	EXPECT_EQ(ReorderTriggers({ "NextTriggerObject(\"rabbit\")", "NumCreature(\"rabbit\",1)", "True()" }), (order_t { 0, 1, 2 }));
+
+	// the whole thing is optional
+	core->config.ReorderTriggers = false;
+	EXPECT_EQ(ReorderTriggers({ "NumCreature(\"rabbit\",1)", "True()" }), (order_t { 0, 1 }));
+	core->config.ReorderTriggers = reorder;
+}
 }
 #endif
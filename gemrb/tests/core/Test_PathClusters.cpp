@@ -0,0 +1,121 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../core/Map.h"
+#include "../../core/PathClusters.h"
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+// an open 64x64 searchmap with a wall down the middle, except for a gap at the bottom
+static TileProps MakeWalledProps()
+{
+	constexpr int side = 64;
+	void* pixels = calloc(side * side, 4);
+	auto sprite = MakeHolder<Sprite2D>(Region(0, 0, side, side), pixels, TileProps::pixelFormat, side * 4);
+	TileProps props(std::move(sprite));
+	for (int y = 0; y < side; ++y) {
+		for (int x = 0; x < side; ++x) {
+			bool wall = x == 40 && y < 60;
+			props.PaintSearchMap(SearchmapPoint(x, y), wall ? PathMapFlags::IMPASSABLE : PathMapFlags::PASSABLE);
+		}
+	}
+	return props;
+}
+
+TEST(PathClustersTest, SameCluster)
+{
+	TileProps props = MakeWalledProps();
+	PathClusters clusters(props);
+	std::vector<SearchmapPoint> waypoints;
+	EXPECT_TRUE(clusters.FindWaypoints(SearchmapPoint(1, 1), SearchmapPoint(10, 12), waypoints));
+	EXPECT_TRUE(waypoints.empty());
+}
+
+TEST(PathClustersTest, GoesAroundWall)
+{
+	TileProps props = MakeWalledProps();
+	PathClusters clusters(props);
+	std::vector<SearchmapPoint> waypoints;
+	ASSERT_TRUE(clusters.FindWaypoints(SearchmapPoint(30, 2), SearchmapPoint(50, 2), waypoints));
+	ASSERT_FALSE(waypoints.empty());
+
+	// the only way across is through the gap in the bottom row of clusters
+	bool reachedGap = false;
+	bool crossed = false;
+	for (const SearchmapPoint& waypoint : waypoints) {
+		EXPECT_EQ(props.QuerySearchMap(waypoint), PathMapFlags::PASSABLE);
+		if (waypoint.y >= 48) {
+			reachedGap = true;
+		}
+		if (waypoint.x > 40) {
+			crossed = true;
+			EXPECT_TRUE(reachedGap);
+		}
+	}
+	EXPECT_TRUE(crossed);
+}
+
+TEST(PathClustersTest, FollowsDoors)
+{
+	TileProps props = MakeWalledProps();
+	PathClusters clusters(props);
+	std::vector<SearchmapPoint> waypoints;
+
+	// close the gap, like a door would
+	for (int y = 60; y < 64; ++y) {
+		props.PaintSearchMap(SearchmapPoint(40, y), PathMapFlags::DOOR_IMPASSABLE);
+	}
+	clusters.Invalidate(Region(40, 60, 1, 4));
+	EXPECT_FALSE(clusters.FindWaypoints(SearchmapPoint(30, 2), SearchmapPoint(50, 2), waypoints));
+
+	// and open it again
+	for (int y = 60; y < 64; ++y) {
+		props.PaintSearchMap(SearchmapPoint(40, y), PathMapFlags::PASSABLE);
+	}
+	clusters.Invalidate(Region(40, 60, 1, 4));
+	EXPECT_TRUE(clusters.FindWaypoints(SearchmapPoint(30, 2), SearchmapPoint(50, 2), waypoints));
+}
+
+TEST(PathClustersTest, PaintedAfterConstruction)
+{
+	TileProps props = MakeWalledProps();
+	for (int y = 60; y < 64; ++y) {
+		props.PaintSearchMap(SearchmapPoint(40, y), PathMapFlags::IMPASSABLE);
+	}
+	PathClusters clusters(props);
+	std::vector<SearchmapPoint> waypoints;
+	EXPECT_FALSE(clusters.FindWaypoints(SearchmapPoint(30, 2), SearchmapPoint(50, 2), waypoints));
+
+	// like the travel regions the area importer marks passable after loading
+	for (int y = 20; y < 24; ++y) {
+		props.PaintSearchMap(SearchmapPoint(40, y), PathMapFlags::PASSABLE);
+	}
+	clusters.Invalidate(Region(40, 20, 1, 4));
+	ASSERT_TRUE(clusters.FindWaypoints(SearchmapPoint(30, 2), SearchmapPoint(50, 2), waypoints));
+	ASSERT_FALSE(waypoints.empty());
+	for (const SearchmapPoint& waypoint : waypoints) {
+		EXPECT_LT(waypoint.y, 48);
+	}
+}
+
+}
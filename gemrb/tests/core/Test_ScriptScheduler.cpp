@@ -0,0 +1,110 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../core/ScriptScheduler.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace GemRB {
+
+using Priority = ScriptScheduler::Priority;
+
+static void SpendOverBudget(ScriptScheduler& scheduler)
+{
+	auto start = ScriptScheduler::clock_t::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	scheduler.Account(start);
+}
+
+TEST(ScriptScheduler_Test, NoBudgetNoLimit)
+{
+	ScriptScheduler scheduler { 0 };
+	SpendOverBudget(scheduler);
+	EXPECT_TRUE(scheduler.Admit(Priority::Idle, 0));
+	EXPECT_EQ(scheduler.GetStats().deferred[Priority::Idle], 0u);
+}
+
+TEST(ScriptScheduler_Test, DefersByPriority)
+{
+	ScriptScheduler scheduler { 1000 };
+	EXPECT_TRUE(scheduler.Admit(Priority::Idle, 0));
+
+	SpendOverBudget(scheduler);
+	EXPECT_TRUE(scheduler.Admit(Priority::Party, 0));
+	EXPECT_TRUE(scheduler.Admit(Priority::Combat, 0));
+	EXPECT_FALSE(scheduler.Admit(Priority::OnScreen, 0));
+	EXPECT_FALSE(scheduler.Admit(Priority::Idle, 0));
+
+	scheduler.NewTick();
+	EXPECT_TRUE(scheduler.Admit(Priority::Idle, 1));
+
+	const ScriptScheduler::Stats& stats = scheduler.GetStats();
+	EXPECT_EQ(stats.run[Priority::Idle], 2u);
+	EXPECT_EQ(stats.deferred[Priority::Idle], 1u);
+	EXPECT_EQ(stats.deferred[Priority::OnScreen], 1u);
+}
+
+TEST(ScriptScheduler_Test, BoundedStaleness)
+{
+	ScriptScheduler scheduler { 1000 };
+	SpendOverBudget(scheduler);
+	EXPECT_FALSE(scheduler.Admit(Priority::Idle, ScriptScheduler::MAX_DEFERRAL - 1));
+	EXPECT_TRUE(scheduler.Admit(Priority::Idle, ScriptScheduler::MAX_DEFERRAL));
+	EXPECT_EQ(scheduler.GetStats().overdue, 1u);
+}
+
+TEST(ScriptScheduler_Test, HeldRoundsRunByPriority)
+{
+	ScriptScheduler scheduler { 1000 };
+	EXPECT_FALSE(scheduler.Hold(Priority::Idle, 1));
+	scheduler.Collect(true);
+	EXPECT_TRUE(scheduler.Hold(Priority::Idle, 2));
+	EXPECT_TRUE(scheduler.Hold(Priority::Triggered, 3));
+	EXPECT_FALSE(scheduler.Hold(Priority::OnScreen, 4));
+	EXPECT_TRUE(scheduler.Hold(Priority::Idle, 5));
+	EXPECT_TRUE(scheduler.Hold(Priority::Triggered, 6));
+
+	// the idle rounds came first, but can't take the budget from the on-screen one
+	EXPECT_TRUE(scheduler.Admit(Priority::OnScreen, 0));
+	SpendOverBudget(scheduler);
+	scheduler.Collect(false);
+
+	std::vector<ScriptScheduler::Round> rounds = scheduler.TakeHeld();
+	ASSERT_EQ(rounds.size(), 4u);
+	const uint32_t order[] = { 3, 6, 2, 5 };
+	for (size_t i = 0; i < rounds.size(); ++i) {
+		EXPECT_EQ(rounds[i].id, order[i]);
+		EXPECT_FALSE(scheduler.Admit(rounds[i].priority, 0));
+	}
+	EXPECT_TRUE(scheduler.TakeHeld().empty());
+	EXPECT_EQ(scheduler.GetStats().deferred[Priority::Idle], 2u);
+	EXPECT_EQ(scheduler.GetStats().deferred[Priority::Triggered], 2u);
+}
+
+TEST(ScriptScheduler_Test, NoBudgetNoHolding)
+{
+	ScriptScheduler scheduler { 0 };
+	scheduler.Collect(true);
+	EXPECT_FALSE(scheduler.Hold(Priority::Idle, 1));
+	EXPECT_TRUE(scheduler.TakeHeld().empty());
+}
+
+}
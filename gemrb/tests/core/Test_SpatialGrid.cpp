@@ -0,0 +1,87 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ *
+ */
+
+#include "../../core/SpatialGrid.h"
+
+#include <gtest/gtest.h>
+
+namespace GemRB {
+
+TEST(SpatialGrid_Test, OnlyNearbyCells)
+{
+	int a = 0, b = 1, c = 2;
+	SpatialGrid<int> grid { Size(100, 100) };
+	grid.Insert(&a, Point(10, 10));
+	grid.Insert(&b, Point(150, 10));
+	grid.Insert(&c, Point(1000, 1000));
+
+	auto near = grid.Query(Region(0, 0, 20, 20));
+	ASSERT_EQ(near.size(), size_t(1));
+	EXPECT_EQ(near[0], &a);
+
+	near = grid.Query(Region(90, 0, 20, 20));
+	EXPECT_EQ(near.size(), size_t(2));
+
+	EXPECT_TRUE(grid.Query(Region(400, 400, 20, 20)).empty());
+}
+
+TEST(SpatialGrid_Test, KeepsInsertionOrder)
+{
+	int items[4] = {};
+	SpatialGrid<int> grid { Size(16, 12) };
+	grid.Insert(&items[0], Point(50, 50));
+	grid.Insert(&items[1], Point(5, 5));
+	grid.Insert(&items[2], Point(-30, 40));
+	grid.Insert(&items[3], Point(20, -7));
+	// moving or reinserting must not change the order either
+	grid.Move(&items[1], Point(60, 60));
+	grid.Insert(&items[0], Point(-5, -5));
+
+	auto all = grid.Query(Region(-100, -100, 300, 300));
+	ASSERT_EQ(all.size(), size_t(4));
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_EQ(all[i], &items[i]);
+	}
+}
+
+TEST(SpatialGrid_Test, MoveAndRemove)
+{
+	int a = 0, b = 1;
+	SpatialGrid<int> grid { Size(64, 64) };
+	grid.Insert(&a, Point(10, 10));
+	grid.Insert(&b, Point(12, 12));
+
+	grid.Move(&a, Point(500, 500));
+	auto near = grid.Query(Region(0, 0, 30, 30));
+	ASSERT_EQ(near.size(), size_t(1));
+	EXPECT_EQ(near[0], &b);
+	near = grid.Query(Region(490, 490, 20, 20));
+	ASSERT_EQ(near.size(), size_t(1));
+	EXPECT_EQ(near[0], &a);
+
+	grid.Remove(&a);
+	EXPECT_FALSE(grid.Contains(&a));
+	EXPECT_TRUE(grid.Query(Region(490, 490, 20, 20)).empty());
+	// unknown objects are not picked up by moves
+	grid.Move(&a, Point(10, 10));
+	EXPECT_EQ(grid.Count(), size_t(1));
+}
+
+}
@@ -0,0 +1,187 @@
+/* GemRB - Infinity Engine Emulator
+ * Copyright (C) 2024 The GemRB Project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "Video/Pixels.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace GemRB {
+
+// odd, so the kernels have leftovers to deal with
+static constexpr int SPAN = 37;
+
+static const PixelFormat RGBA = PixelFormat::ARGB32Bit();
+// like the SDL 1.2 screen surface: no alpha channel at all
+static const PixelFormat RGBX = PixelFormat(0, 0, 0, 8, 16, 8, 0, 0, 0x00FF0000, 0x0000FF00, 0x000000FF, 0, 4, 32, 0, false, false, {});
+static const PixelFormat BGRA = PixelFormat(0, 0, 0, 0, 0, 8, 16, 24, 0x000000FF, 0x0000FF00, 0x00FF0000, 0xFF000000, 4, 32, 0, false, false, {});
+
+static std::vector<uint32_t> RandomPixels(std::mt19937& rng)
+{
+	std::vector<uint32_t> pixels(SPAN);
+	for (auto& px : pixels) {
+		px = rng();
+		// plenty of the special alpha values
+		switch (rng() % 4) {
+			case 0:
+				px &= 0x00ffffff;
+				break;
+			case 1:
+				px |= 0xff000000;
+				break;
+			default:
+				break;
+		}
+	}
+	return pixels;
+}
+
+// the per pixel path the kernels replace
+template<typename BLENDER>
+static void ReferenceBlit(std::vector<uint32_t> src, const PixelFormat& srcFmt, std::vector<uint32_t>& dst, const PixelFormat& dstFmt,
+			  const std::vector<uint8_t>& mask, const BLENDER& blender)
+{
+	PixelFormatIterator srcIt(src.data(), SPAN * 4, srcFmt, Region(0, 0, SPAN, 1));
+	PixelFormatIterator dstIt(dst.data(), SPAN * 4, dstFmt, Region(0, 0, SPAN, 1));
+	for (int i = 0; i < SPAN; ++i, ++srcIt, ++dstIt) {
+		Color srcc = srcIt.ReadRGBA();
+		Color dstc = dstIt.ReadRGBA();
+		blender(srcc, dstc, mask[i]);
+		dstIt.WriteRGBA(dstc.r, dstc.g, dstc.b, dstc.a);
+	}
+}
+
+template<SHADER SHADE>
+static void CheckPipeline(const RGBBlendingPipeline<SHADE, true>& blender, const PixelFormat& srcFmt, const PixelFormat& dstFmt, std::mt19937& rng)
+{
+	ASSERT_TRUE(blender.HasSpanKernel());
+	for (int round = 0; round < 20; ++round) {
+		auto src = RandomPixels(rng);
+		auto dst = RandomPixels(rng);
+		std::vector<uint8_t> mask(SPAN, 0);
+		if (round % 2) {
+			for (auto& m : mask) {
+				m = rng() % 3 ? 0 : uint8_t(rng());
+			}
+		}
+
+		auto expected = dst;
+		ReferenceBlit(src, srcFmt, expected, dstFmt, mask, blender);
+		blender.BlendRow(src.data(), srcFmt, dst.data(), dstFmt, round % 2 ? mask.data() : nullptr, SPAN);
+		EXPECT_EQ(dst, expected);
+	}
+}
+
+TEST(Pixels_Test, SpanFormats)
+{
+	EXPECT_TRUE(IsSpanFormat(RGBA));
+	EXPECT_TRUE(IsSpanFormat(RGBX));
+	EXPECT_TRUE(IsSpanFormat(BGRA));
+
+	PixelFormat keyed = RGBX;
+	keyed.HasColorKey = true;
+	EXPECT_FALSE(IsSpanFormat(keyed));
+
+	PixelFormat rgb565(2, 0xF800, 0x07E0, 0x001F, 0);
+	EXPECT_FALSE(IsSpanFormat(rgb565));
+}
+
+TEST(Pixels_Test, BlendSpanMatchesPipeline)
+{
+	std::mt19937 rng(1234);
+	const Color tint(200, 120, 64, 128);
+	const PixelFormat* formats[] = { &RGBA, &RGBX, &BGRA };
+
+	for (const PixelFormat* srcFmt : { &RGBA, &BGRA }) {
+		for (const PixelFormat* dstFmt : formats) {
+			CheckPipeline(RGBBlendingPipeline<SHADER::NONE, true>(), *srcFmt, *dstFmt, rng);
+			CheckPipeline(RGBBlendingPipeline<SHADER::TINT, true>(tint), *srcFmt, *dstFmt, rng);
+			CheckPipeline(RGBBlendingPipeline<SHADER::GREYSCALE, true>(), *srcFmt, *dstFmt, rng);
+			CheckPipeline(RGBBlendingPipeline<SHADER::GREYSCALE, true>(tint), *srcFmt, *dstFmt, rng);
+			CheckPipeline(RGBBlendingPipeline<SHADER::SEPIA, true>(), *srcFmt, *dstFmt, rng);
+			CheckPipeline(RGBBlendingPipeline<SHADER::SEPIA, true>(tint), *srcFmt, *dstFmt, rng);
+		}
+	}
+
+	EXPECT_FALSE((RGBBlendingPipeline<SHADER::NONE, true>(ShaderAdditive).HasSpanKernel()));
+}
+
+TEST(Pixels_Test, FillSpanMatchesBlenders)
+{
+	std::mt19937 rng(4321);
+	for (const PixelFormat* dstFmt : { &RGBA, &RGBX, &BGRA }) {
+		for (int round = 0; round < 20; ++round) {
+			Color c(rng(), rng(), rng(), rng());
+			auto dst = RandomPixels(rng);
+			std::vector<uint8_t> mask(SPAN, 0);
+
+			auto blended = dst;
+			ReferenceBlit(std::vector<uint32_t>(SPAN, 0), *dstFmt, blended, *dstFmt, mask,
+				      [c](const Color&, Color& d, uint8_t m) { OneMinusSrcA<false, false>()(c, d, m); });
+			auto spanned = dst;
+			FillSpan(c, spanned.data(), *dstFmt, SPAN, SHADER::BLEND);
+			EXPECT_EQ(spanned, blended);
+
+			auto tinted = dst;
+			ReferenceBlit(std::vector<uint32_t>(SPAN, 0), *dstFmt, tinted, *dstFmt, mask,
+				      [c](const Color&, Color& d, uint8_t m) { TintDst<false>()(c, d, m); });
+			spanned = dst;
+			FillSpan(c, spanned.data(), *dstFmt, SPAN, SHADER::TINT);
+			EXPECT_EQ(spanned, tinted);
+
+			auto copied = dst;
+			ReferenceBlit(std::vector<uint32_t>(SPAN, 0), *dstFmt, copied, *dstFmt, mask,
+				      [c](const Color&, Color& d, uint8_t m) { SrcRGBA<false>()(c, d, m); });
+			spanned = dst;
+			FillSpan(c, spanned.data(), *dstFmt, SPAN, SHADER::NONE);
+			EXPECT_EQ(spanned, copied);
+		}
+	}
+}
+
+TEST(Pixels_Test, ColorFillFallsBackForOtherTargets)
+{
+	const Color c(200, 120, 64, 128);
+	const Region rect(0, 0, SPAN, 3);
+
+	// not a span format at all
+	PixelFormat rgb565(2, 0xF800, 0x07E0, 0x001F, 0);
+	std::vector<uint16_t> shorts(SPAN * 3, 0x1234);
+	PixelFormatIterator shortIt(shorts.data(), SPAN * 2, rgb565, rect);
+	ColorFill(c, shortIt, PixelFormatIterator::end(shortIt), OneMinusSrcA<false, false>());
+
+	std::vector<uint16_t> expectedShorts(SPAN * 3, 0x1234);
+	PixelFormatIterator refIt(expectedShorts.data(), SPAN * 2, rgb565, rect);
+	ColorFill<OneMinusSrcA<false, false>>(c, refIt, PixelFormatIterator::end(refIt), OneMinusSrcA<false, false>());
+	EXPECT_EQ(shorts, expectedShorts);
+	EXPECT_NE(shorts[0], 0x1234);
+
+	// mirrored 32bpp rows can't go through the kernels either
+	std::mt19937 rng(99);
+	auto pixels = RandomPixels(rng);
+	auto expected = pixels;
+	PixelFormatIterator mirrored(pixels.data(), SPAN * 4, RGBA, IPixelIterator::Reverse, IPixelIterator::Forward, Region(0, 0, SPAN, 1));
+	ColorFill(c, mirrored, PixelFormatIterator::end(mirrored), TintDst<false>());
+	ReferenceBlit(std::vector<uint32_t>(SPAN, 0), RGBA, expected, RGBA, std::vector<uint8_t>(SPAN, 0),
+		      [c](const Color&, Color& d, uint8_t m) { TintDst<false>()(c, d, m); });
+	EXPECT_EQ(pixels, expected);
+}
+
+}